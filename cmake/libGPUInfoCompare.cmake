@@ -0,0 +1,84 @@
+#
+# Copyright (c) 2024 Arm Limited.
+#
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+
+# Check that two programs write identical reports.
+#
+# Usage:
+#
+#   cmake -DFIRST=<program> -DSECOND=<program> -P libGPUInfoCompare.cmake
+#
+# Each program is run without arguments, and must succeed. The script fails
+# if the two programs write different output to stdout, and reports the first
+# line that differs.
+
+cmake_policy(SET CMP0007 NEW)
+
+if(NOT FIRST OR NOT SECOND)
+    message(FATAL_ERROR "FIRST and SECOND must be specified")
+endif()
+
+foreach(PROGRAM IN ITEMS FIRST SECOND)
+    execute_process(
+        COMMAND ${${PROGRAM}}
+        OUTPUT_VARIABLE ${PROGRAM}_OUTPUT
+        RESULT_VARIABLE RESULT)
+
+    if(NOT RESULT EQUAL 0)
+        message(FATAL_ERROR "${${PROGRAM}} failed: ${RESULT}")
+    endif()
+endforeach()
+
+if(FIRST_OUTPUT STREQUAL SECOND_OUTPUT)
+    string(REGEX MATCHALL "\n" LINES "${FIRST_OUTPUT}")
+    list(LENGTH LINES NUM_LINES)
+    message(STATUS "PASS: ${NUM_LINES} lines match")
+    return()
+endif()
+
+# Lists cannot hold semicolons, so escape them before splitting into lines
+foreach(PROGRAM IN ITEMS FIRST SECOND)
+    string(REPLACE ";" "\;" ${PROGRAM}_OUTPUT "${${PROGRAM}_OUTPUT}")
+    string(REGEX REPLACE "\n$" "" ${PROGRAM}_OUTPUT "${${PROGRAM}_OUTPUT}")
+    string(REPLACE "\n" ";" ${PROGRAM}_LINES "${${PROGRAM}_OUTPUT}")
+endforeach()
+
+list(LENGTH FIRST_LINES FIRST_COUNT)
+list(LENGTH SECOND_LINES SECOND_COUNT)
+foreach(INDEX RANGE ${FIRST_COUNT})
+    if(INDEX EQUAL FIRST_COUNT OR INDEX EQUAL SECOND_COUNT)
+        break()
+    endif()
+
+    list(GET FIRST_LINES ${INDEX} FIRST_LINE)
+    list(GET SECOND_LINES ${INDEX} SECOND_LINE)
+    if(NOT FIRST_LINE STREQUAL SECOND_LINE)
+        math(EXPR LINE_NUMBER "${INDEX} + 1")
+        message(FATAL_ERROR
+            "FAIL: Line ${LINE_NUMBER} differs\n"
+            "    ${FIRST}: ${FIRST_LINE}\n"
+            "    ${SECOND}: ${SECOND_LINE}")
+    endif()
+endforeach()
+
+message(FATAL_ERROR "FAIL: ${FIRST} wrote ${FIRST_COUNT} lines, ${SECOND} wrote ${SECOND_COUNT} lines")
@@ -0,0 +1,109 @@
+#
+# Copyright (c) 2024 Arm Limited.
+#
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+
+# Report the code size and static constructor count of a built binary.
+#
+# Usage:
+#
+#   cmake -DREADELF=<readelf> -DBINARY=<file> [-DMAX_CONSTRUCTORS=<n>]
+#         -P libGPUInfoFootprint.cmake
+#
+# The binary can be an object file, a static archive, or a shared object. The
+# sizes of all allocated sections are summed over all archive members, and the
+# static constructor count is derived from the size of the .init_array and
+# .ctors sections. If MAX_CONSTRUCTORS is set the script fails when the binary
+# contains more static constructors than the limit.
+
+if(NOT READELF OR NOT BINARY)
+    message(FATAL_ERROR "READELF and BINARY must be specified")
+endif()
+
+execute_process(
+    COMMAND ${READELF} -S -W ${BINARY}
+    OUTPUT_VARIABLE SECTIONS
+    RESULT_VARIABLE RESULT)
+
+if(NOT RESULT EQUAL 0)
+    message(FATAL_ERROR "Failed to read sections from ${BINARY}")
+endif()
+
+execute_process(
+    COMMAND ${READELF} -h ${BINARY}
+    OUTPUT_VARIABLE HEADER)
+
+if(HEADER MATCHES "ELF64")
+    set(POINTER_SIZE 8)
+else()
+    set(POINTER_SIZE 4)
+endif()
+
+set(CODE_BYTES 0)
+set(DATA_BYTES 0)
+set(BSS_BYTES 0)
+set(CONSTRUCTOR_BYTES 0)
+
+string(REPLACE "\n" ";" SECTION_LINES "${SECTIONS}")
+foreach(LINE IN LISTS SECTION_LINES)
+    # [Nr] Name Type Address Off Size ES Flg Lk Inf Al
+    if(NOT LINE MATCHES "^ *\\[ *[0-9]+\\] +([^ ]+) +([^ ]+) +[0-9a-f]+ +[0-9a-f]+ +([0-9a-f]+) +[0-9a-f]+ +([A-Za-z]*) ")
+        continue()
+    endif()
+
+    set(NAME "${CMAKE_MATCH_1}")
+    set(TYPE "${CMAKE_MATCH_2}")
+    math(EXPR SIZE "0x${CMAKE_MATCH_3}")
+    set(FLAGS "${CMAKE_MATCH_4}")
+
+    if(NAME STREQUAL ".init_array" OR NAME MATCHES "^\\.init_array\\." OR
+       NAME STREQUAL ".ctors" OR NAME MATCHES "^\\.ctors\\.")
+        math(EXPR CONSTRUCTOR_BYTES "${CONSTRUCTOR_BYTES} + ${SIZE}")
+    endif()
+
+    if(NOT "${FLAGS}" MATCHES "A")
+        continue()
+    endif()
+
+    if("${TYPE}" STREQUAL "NOBITS")
+        math(EXPR BSS_BYTES "${BSS_BYTES} + ${SIZE}")
+    elseif("${FLAGS}" MATCHES "X")
+        math(EXPR CODE_BYTES "${CODE_BYTES} + ${SIZE}")
+    else()
+        math(EXPR DATA_BYTES "${DATA_BYTES} + ${SIZE}")
+    endif()
+endforeach()
+
+math(EXPR CONSTRUCTORS "${CONSTRUCTOR_BYTES} / ${POINTER_SIZE}")
+
+get_filename_component(BINARY_NAME ${BINARY} NAME)
+message(STATUS
+    "${BINARY_NAME}: code ${CODE_BYTES} bytes, data ${DATA_BYTES} bytes, "
+    "bss ${BSS_BYTES} bytes, static constructors ${CONSTRUCTORS}")
+
+if(DEFINED MAX_CONSTRUCTORS AND NOT MAX_CONSTRUCTORS STREQUAL "")
+    if(CONSTRUCTORS GREATER MAX_CONSTRUCTORS)
+        message(FATAL_ERROR
+            "${BINARY_NAME}: ${CONSTRUCTORS} static constructors exceeds "
+            "limit of ${MAX_CONSTRUCTORS}")
+    endif()
+endif()
@@ -48,6 +48,7 @@
 #include <iostream>
 #include <sys/utsname.h>
 #include <cstring>
+#include <utility>
 
 #if defined(__ANDROID__)
     #include <sys/system_properties.h>
@@ -55,6 +56,55 @@
 
 #include "libgpuinfo.hpp"
 
+/** Names of the compressed texture format families. */
+const std::pair<libarmgpuinfo::texture_format, const char*> TEXTURE_FORMAT_NAMES[] {
+    { libarmgpuinfo::texture_format::astc_ldr, "ASTC LDR" },
+    { libarmgpuinfo::texture_format::astc_hdr, "ASTC HDR" },
+    { libarmgpuinfo::texture_format::astc_3d_ldr, "ASTC 3D LDR" },
+    { libarmgpuinfo::texture_format::astc_3d_hdr, "ASTC 3D HDR" },
+    { libarmgpuinfo::texture_format::etc2, "ETC2" },
+    { libarmgpuinfo::texture_format::eac, "EAC" },
+    { libarmgpuinfo::texture_format::bc1, "BC1" },
+    { libarmgpuinfo::texture_format::bc2, "BC2" },
+    { libarmgpuinfo::texture_format::bc3, "BC3" },
+    { libarmgpuinfo::texture_format::bc4, "BC4" },
+    { libarmgpuinfo::texture_format::bc5, "BC5" },
+    { libarmgpuinfo::texture_format::bc6h, "BC6H" },
+    { libarmgpuinfo::texture_format::bc7, "BC7" }
+};
+
+const char* get_scheduler_name(
+    libarmgpuinfo::scheduler_type scheduler
+) {
+    switch (scheduler)
+    {
+    case libarmgpuinfo::scheduler_type::job_manager:
+        return "Job Manager";
+    case libarmgpuinfo::scheduler_type::csf:
+        return "CSF";
+    case libarmgpuinfo::scheduler_type::unknown:
+        break;
+    }
+
+    return "Unknown";
+}
+
+const char* get_coherency_name(
+    libarmgpuinfo::coherency_protocol protocol
+) {
+    switch (protocol)
+    {
+    case libarmgpuinfo::coherency_protocol::ace_lite:
+        return "ACE-Lite";
+    case libarmgpuinfo::coherency_protocol::ace:
+        return "ACE";
+    case libarmgpuinfo::coherency_protocol::none:
+        break;
+    }
+
+    return "None";
+}
+
 #if defined(__ANDROID__)
 std::string get_android_property(
     const char* propertyA,
@@ -111,6 +161,7 @@ int main(int argc, char *argv[])
     std::cout << "  Android version: " << get_android_property("ro.build.version.release") << "\n";
 #endif
     std::cout << "  Kernel version: " << get_kernel_version() << "\n";
+    std::cout << "  Released kernel memory: " << instance->get_released_kernel_bytes() << " bytes\n";
     if (!emit_yaml)
     {
         std::cout << "\n";
@@ -124,9 +175,54 @@ int main(int argc, char *argv[])
     std::cout << "  Model number: 0x" << std::hex << info.gpu_id << std::dec << "\n";
     std::cout << "  Core count: " << info.num_shader_cores << "\n";
     std::cout << "  Core mask: 0x" << std::hex << info.shader_core_mask << std::dec << "\n";
+    std::cout << "  Core group count: " << info.topology.num_groups << "\n";
+    if (info.topology.num_groups > 1)
+    {
+        std::cout << "  Core groups:\n";
+        for (uint32_t i = 0; i < info.topology.num_groups; i++)
+        {
+            const auto& group = info.topology.groups[i];
+            std::cout << "    - Core mask: 0x" << std::hex << group.core_mask << std::dec
+                      << ", L2 cache: " << group.l2_index << "\n";
+        }
+    }
     std::cout << "  L2 cache count: " << info.num_l2_slices << "\n";
     std::cout << "  Total L2 cache size: " << info.num_l2_bytes << " bytes\n";
+    std::cout << "  L2 cache slice size: " << info.num_l2_slice_bytes << " bytes\n";
+    std::cout << "  L2 cache line size: " << info.num_l2_line_bytes << " bytes\n";
     std::cout << "  Bus width: " << info.num_bus_bits << " bits\n";
+    std::cout << "  GPU memory size: " << info.num_gpu_memory_bytes << " bytes\n";
+    std::cout << "  Virtual address size: " << info.num_va_bits << " bits\n";
+    std::cout << "  Physical address size: " << info.num_pa_bits << " bits\n";
+    std::cout << "  Address space count: " << info.num_address_spaces << "\n";
+    std::cout << "  Coherency: " << get_coherency_name(info.coherency) << "\n";
+    std::cout << "  Tiler bin size: " << info.tiler.bin_size_bytes << " bytes\n";
+    std::cout << "  Tiler active level count: " << info.tiler.max_active_levels << "\n";
+    std::cout << "  Scheduler: " << get_scheduler_name(info.queues.scheduler) << "\n";
+    if (info.queues.scheduler == libarmgpuinfo::scheduler_type::csf)
+    {
+        std::cout << "  Queue group count: " << info.queues.num_queue_groups << "\n";
+        std::cout << "  Queues per group: " << info.queues.num_queues_per_group << "\n";
+    }
+    else
+    {
+        std::cout << "  Job slot count: " << info.queues.num_job_slots << "\n";
+        std::cout << "  Compute job slot count: " << info.queues.num_compute_slots << "\n";
+        std::cout << "  Fragment job slot count: " << info.queues.num_fragment_slots << "\n";
+    }
+    std::cout << "  Compressed texture formats:";
+    if (!info.texture_formats)
+    {
+        std::cout << " []";
+    }
+    std::cout << "\n";
+    for (const auto& format : TEXTURE_FORMAT_NAMES)
+    {
+        if (libarmgpuinfo::has_texture_format(info, format.first))
+        {
+            std::cout << "    - " << format.second << "\n";
+        }
+    }
     if (!emit_yaml)
     {
         std::cout << "\n";
@@ -143,8 +239,12 @@ int main(int argc, char *argv[])
     std::cout << "  Engine count: " << info.num_exec_engines << "\n";
     std::cout << "  FP32 FMAs: " << info.num_fp32_fmas_per_cy << "/cy\n";
     std::cout << "  FP16 FMAs: " << info.num_fp16_fmas_per_cy << "/cy\n";
+    std::cout << "  Int8 dot product MACs: " << info.num_int8_macs_per_cy << "/cy\n";
+    std::cout << "  FP16 dot product MACs: " << info.num_fp16_macs_per_cy << "/cy\n";
     std::cout << "  Texels: " << info.num_texels_per_cy << "/cy\n";
     std::cout << "  Pixels: " << info.num_pixels_per_cy << "/cy\n";
+    std::cout << "  Max threads: " << info.num_threads_per_core << "\n";
+    std::cout << "  Register file size: " << info.num_registers_per_core << " registers\n";
     if (!emit_yaml)
     {
         std::cout << "\n";
@@ -153,8 +253,11 @@ int main(int argc, char *argv[])
     std::cout << "Per-GPU statistics:\n";
     std::cout << "  FP32 FMAs: " << info.num_fp32_fmas_per_cy * info.num_shader_cores << "/cy\n";
     std::cout << "  FP16 FMAs: " << info.num_fp16_fmas_per_cy * info.num_shader_cores << "/cy\n";
+    std::cout << "  Int8 dot product MACs: " << info.num_int8_macs_per_cy * info.num_shader_cores << "/cy\n";
+    std::cout << "  FP16 dot product MACs: " << info.num_fp16_macs_per_cy * info.num_shader_cores << "/cy\n";
     std::cout << "  Texels: " << info.num_texels_per_cy * info.num_shader_cores << "/cy\n";
     std::cout << "  Pixels: " << info.num_pixels_per_cy * info.num_shader_cores << "/cy\n";
+    std::cout << "  Tiler primitives: " << info.tiler.num_prims_per_cy << "/cy\n";
 
     return 0;
 }
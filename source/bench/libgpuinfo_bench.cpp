@@ -0,0 +1,567 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Benchmarks for the libGPUInfo catalog, decoder, and query path.
+ *
+ * Usage:
+ *
+ *     libgpuinfo_bench [--output <file>] [--golden <file>]
+ *                      [--baseline <file>] [--tolerance <x>]
+ *
+ * Results are written as JSON to stdout, or to the output file if specified.
+ * If a golden file is specified, the synthetic corpus is verified against the
+ * golden results before it is benchmarked, so that an optimization cannot
+ * silently change the decoded results.
+ * If a baseline file is specified, each result is compared against the
+ * baseline result of the same name, and the tool fails if any result is
+ * slower than the baseline by more than the tolerance, given as a fraction of
+ * the baseline time. Times are compared relative to a reference benchmark
+ * that does not use the library, so baselines can be used on any machine.
+ * The relative times depend on the optimization level, so results are only
+ * compared if the baseline was recorded from a build with the same
+ * optimization level: for speed, for size, or none. Regenerate the baseline
+ * with --output when the benchmarks change.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "libgpuinfo.hpp"
+#include "libgpuinfo_decoder.hpp"
+#include "libgpuinfo_products.hpp"
+#include "fake_driver/libgpuinfo_corpus.hpp"
+#include "fake_driver/libgpuinfo_fake_driver.hpp"
+#include "fake_driver/libgpuinfo_population.hpp"
+
+using namespace libarmgpuinfo;
+
+namespace {
+
+/** The minimum run time of a benchmark, used to scale the iteration count. */
+constexpr std::chrono::milliseconds min_run_time { 100 };
+
+/** The number of timed runs of each benchmark; the fastest run is reported. */
+constexpr int num_runs { 10 };
+
+/** The name of the reference benchmark, which does not use the library. */
+const char* const reference_name { "reference" };
+
+/**
+ * The optimization level the benchmarks were compiled with. The level changes
+ * the relative cost of each benchmark, so results are only compared against a
+ * baseline recorded with the same level.
+ */
+#if defined(__OPTIMIZE_SIZE__)
+const char* const optimization { "size" };
+#elif defined(__OPTIMIZE__)
+const char* const optimization { "speed" };
+#else
+const char* const optimization { "none" };
+#endif
+
+/** The default tolerance when comparing against a baseline. */
+constexpr double default_tolerance { 1.0 };
+
+/** Result of a single benchmark. */
+struct result {
+    /** The benchmark name. */
+    std::string name;
+    /** The time per operation, in nanoseconds. */
+    double ns_per_op;
+    /** The number of operations per timed run. */
+    uint64_t iterations;
+};
+
+/** Prevent the compiler from optimizing away a computed value. */
+template <typename T>
+void keep(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Run a benchmark.
+ *
+ * @param name   The benchmark name.
+ * @param ops    The number of operations performed by each call to @c body.
+ * @param body   The benchmark body.
+ *
+ * @return The benchmark result.
+ */
+template <typename F>
+result run(const std::string& name, uint64_t ops, F body)
+{
+    using clock = std::chrono::steady_clock;
+
+    // Scale the iteration count until a run takes at least the minimum time
+    uint64_t iterations { 1 };
+    while (true) {
+        auto start = clock::now();
+        for (uint64_t i = 0; i < iterations; i++) {
+            body();
+        }
+
+        if ((clock::now() - start) >= min_run_time) {
+            break;
+        }
+
+        iterations *= 2;
+    }
+
+    double best { 0.0 };
+    for (int r = 0; r < num_runs; r++) {
+        auto start = clock::now();
+        for (uint64_t i = 0; i < iterations; i++) {
+            body();
+        }
+
+        std::chrono::duration<double, std::nano> elapsed = clock::now() - start;
+        double ns = elapsed.count() / static_cast<double>(iterations * ops);
+        if ((r == 0) || (ns < best)) {
+            best = ns;
+        }
+    }
+
+    return { name, best, iterations * ops };
+}
+
+/**
+ * Benchmark a fixed workload that does not use the library.
+ *
+ * The workload hashes a small buffer through a lookup table and copies it,
+ * a mix of dependent integer arithmetic, table lookups, and byte copies
+ * similar to the library code paths. Baseline comparisons are made relative
+ * to this benchmark, so they do not depend on the speed of the machine.
+ */
+result bench_reference()
+{
+    std::vector<uint32_t> table(256);
+    std::vector<unsigned char> src(256);
+    std::vector<unsigned char> dst(256);
+
+    uint32_t state { 1 };
+    for (std::size_t i = 0; i < table.size(); i++) {
+        state = state * 1664525U + 1013904223U;
+        table[i] = state;
+        src[i] = static_cast<unsigned char>(state >> 24);
+    }
+
+    return run(reference_name, 1, [&] {
+        uint32_t hash { 2166136261U };
+        for (unsigned char byte : src) {
+            hash = (hash ^ table[(hash ^ byte) & 0xFF]) * 16777619U;
+        }
+
+        std::memcpy(dst.data(), src.data(), src.size());
+        keep(dst[hash & 0xFF]);
+        keep(hash);
+    });
+}
+
+/** Benchmark product lookup for every catalog entry. */
+result bench_lookup_catalog()
+{
+    constexpr auto num_entries = sizeof(detail::PRODUCT_VERSIONS) / sizeof(detail::PRODUCT_VERSIONS[0]);
+
+    return run("lookup_catalog", num_entries, [] {
+        for (const auto& entry : detail::PRODUCT_VERSIONS) {
+            gpuinfo info = get_product_info(entry.id, 8);
+            keep(info.num_fp32_fmas_per_cy);
+        }
+    });
+}
+
+/** Benchmark batch product lookup for every catalog entry at a range of core counts. */
+result bench_lookup_batch()
+{
+    std::vector<uint32_t> ids;
+    std::vector<uint32_t> cores;
+    for (uint32_t num_cores = 1; num_cores <= 16; num_cores++) {
+        for (const auto& entry : detail::PRODUCT_VERSIONS) {
+            ids.push_back(entry.id);
+            cores.push_back(num_cores);
+        }
+    }
+
+    const std::size_t count = ids.size();
+    std::vector<uint32_t> fp32_fmas(count);
+    std::vector<uint32_t> texels(count);
+    const product_config_columns configs { ids.data(), cores.data(), nullptr, nullptr };
+    gpuinfo_columns columns {};
+    columns.num_fp32_fmas_per_cy = fp32_fmas.data();
+    columns.num_texels_per_cy = texels.data();
+
+    return run("lookup_batch", count, [&] {
+        get_product_info_batch(configs, count, columns);
+        keep(fp32_fmas[count - 1]);
+    });
+}
+
+/** Benchmark product lookup for IDs that are not in the catalog. */
+result bench_lookup_unknown()
+{
+    static const uint32_t unknown_ids[] { 0x0000, 0x1234, 0x5fff, 0xbeef, 0xffff };
+    constexpr auto num_ids = sizeof(unknown_ids) / sizeof(unknown_ids[0]);
+
+    return run("lookup_unknown", num_ids, [] {
+        for (uint32_t id : unknown_ids) {
+            gpuinfo info = get_product_info(id, 8);
+            keep(info.num_fp32_fmas_per_cy);
+        }
+    });
+}
+
+/** Benchmark property decoding for a property buffer. */
+result bench_decode(const std::string& name, const fake::fake_gpu& gpu)
+{
+    const auto buffer = fake::encode_post_r21_props(gpu);
+
+    return run(name, 1, [&buffer] {
+        gpuinfo info {};
+        detail::prop_decoder decoder { buffer.data(), buffer.size() };
+        bool ok = decoder.decode(info);
+        keep(ok);
+        keep(info.num_fp32_fmas_per_cy);
+    });
+}
+
+/** Benchmark offline capture decoding for every case in the synthetic corpus. */
+result bench_decode_corpus(const std::vector<fake::corpus_case>& corpus)
+{
+    std::vector<std::vector<unsigned char>> captures;
+    for (const auto& test : corpus) {
+        captures.push_back(fake::encode_capture(test.gpu));
+    }
+
+    return run("decode_corpus", captures.size(), [&captures] {
+        for (const auto& capture : captures) {
+            gpuinfo info {};
+            bool ok = decode_capture(capture.data(), capture.size(), info);
+            keep(ok);
+            keep(info.num_fp32_fmas_per_cy);
+        }
+    });
+}
+
+/** Benchmark synthetic population generation, per generated device capture. */
+result bench_generate_population()
+{
+    constexpr uint64_t records_per_call { 4096 };
+
+    fake::population_generator generator(fake::population_config {});
+    std::size_t max_size { 0 };
+    for (uint32_t i = 0; i < generator.get_configs().size(); i++) {
+        std::size_t size { 0 };
+        generator.get_capture(i, size);
+        max_size = std::max(max_size, size);
+    }
+
+    std::vector<unsigned char> buffer(max_size * records_per_call);
+    return run("generate_population", records_per_call, [&generator, &buffer] {
+        uint64_t num_records { 0 };
+        std::size_t size = generator.generate(buffer.data(), buffer.size(), records_per_call, num_records);
+        keep(size);
+        keep(num_records);
+    });
+}
+
+/** Benchmark the full instance creation and query using the fake driver. */
+result bench_create(const std::string& name, const fake::fake_gpu& gpu)
+{
+    fake::remove_devices();
+    fake::install_device(gpu);
+    const auto& driver = fake::get_driver();
+
+    if (!instance::create(0, driver)) {
+        std::cerr << "ERROR: Failed to create instance for " << name << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    auto res = run(name, 1, [&driver] {
+        auto inst = instance::create(0, driver);
+        keep(inst->get_info().num_fp32_fmas_per_cy);
+    });
+
+    fake::remove_devices();
+    return res;
+}
+
+/** Write the results as JSON. */
+void write_json(std::ostream& out, const std::vector<result>& results)
+{
+    out << "{\n";
+    out << "  \"optimization\": \"" << optimization << "\",\n";
+    out << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        char ns[32];
+        snprintf(ns, sizeof(ns), "%.2f", results[i].ns_per_op);
+
+        out << "    { \"name\": \"" << results[i].name << "\", "
+            << "\"ns_per_op\": " << ns << ", "
+            << "\"iterations\": " << results[i].iterations << " }"
+            << ((i + 1 < results.size()) ? ",\n" : "\n");
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+/**
+ * Read the results from a JSON file written by this tool.
+ *
+ * This is not a general JSON parser; it relies on each result being on a
+ * single line, as written by @c write_json().
+ *
+ * @param path        The file path.
+ * @param results     The returned time per operation of each benchmark.
+ * @param level       The returned optimization level of the benchmarks.
+ *
+ * @return @c true if the file was read, @c false otherwise.
+ */
+bool read_json(const std::string& path, std::map<std::string, double>& results, std::string& level)
+{
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+
+    // Baselines that predate the level were recorded from release builds
+    level = "speed";
+
+    std::string line;
+    while (std::getline(in, line)) {
+        const std::string level_key { "\"optimization\": \"" };
+        auto level_pos = line.find(level_key);
+        if (level_pos != std::string::npos) {
+            level_pos += level_key.size();
+            auto level_end = line.find('"', level_pos);
+            if (level_end == std::string::npos) {
+                return false;
+            }
+
+            level = line.substr(level_pos, level_end - level_pos);
+            continue;
+        }
+
+        const std::string name_key { "\"name\": \"" };
+        const std::string ns_key { "\"ns_per_op\": " };
+
+        auto name_pos = line.find(name_key);
+        auto ns_pos = line.find(ns_key);
+        if ((name_pos == std::string::npos) || (ns_pos == std::string::npos)) {
+            continue;
+        }
+
+        name_pos += name_key.size();
+        auto name_end = line.find('"', name_pos);
+        if (name_end == std::string::npos) {
+            return false;
+        }
+
+        std::string name = line.substr(name_pos, name_end - name_pos);
+        results[name] = std::strtod(line.c_str() + ns_pos + ns_key.size(), nullptr);
+    }
+
+    return !results.empty();
+}
+
+/**
+ * Compare results against a baseline.
+ *
+ * Each limit is the baseline time scaled by the ratio of the current and
+ * baseline reference times, so a baseline recorded on one machine can be
+ * used on another.
+ */
+bool compare(
+    const std::vector<result>& results,
+    const std::map<std::string, double>& baseline,
+    double tolerance
+) {
+    auto reference = std::find_if(results.begin(), results.end(), [](const result& res) {
+        return res.name == reference_name;
+    });
+
+    auto baseline_reference = baseline.find(reference_name);
+    if ((reference == results.end()) || (baseline_reference == baseline.end()) ||
+        (baseline_reference->second <= 0.0)) {
+        std::cerr << "  " << reference_name << ": no baseline\n";
+        return false;
+    }
+
+    const double scale = reference->ns_per_op / baseline_reference->second;
+    std::cerr << "  Machine speed relative to the baseline: " << (1.0 / scale) << "x\n";
+
+    bool pass { true };
+
+    for (const auto& res : results) {
+        auto it = baseline.find(res.name);
+        if (res.name == reference_name) {
+            continue;
+        }
+
+        if (it == baseline.end()) {
+            std::cerr << "  " << res.name << ": no baseline\n";
+            continue;
+        }
+
+        double limit = it->second * scale * (1.0 + tolerance);
+        bool ok = res.ns_per_op <= limit;
+        pass = pass && ok;
+
+        char line[160];
+        snprintf(line, sizeof(line), "  %-24s %10.2f ns (baseline %10.2f ns, limit %10.2f ns) %s\n",
+                 res.name.c_str(), res.ns_per_op, it->second, limit, ok ? "ok" : "REGRESSED");
+        std::cerr << line;
+    }
+
+    return pass;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    std::string output_path;
+    std::string golden_path;
+    std::string baseline_path;
+    double tolerance { default_tolerance };
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg { argv[i] };
+        if ((arg == "--output") && (i + 1 < argc)) {
+            output_path = argv[++i];
+        } else if ((arg == "--golden") && (i + 1 < argc)) {
+            golden_path = argv[++i];
+        } else if ((arg == "--baseline") && (i + 1 < argc)) {
+            baseline_path = argv[++i];
+        } else if ((arg == "--tolerance") && (i + 1 < argc)) {
+            tolerance = std::strtod(argv[++i], nullptr);
+        } else {
+            std::cerr << "Usage: libgpuinfo_bench [--output <file>] [--golden <file>] "
+                         "[--baseline <file>] [--tolerance <x>]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Results must be correct before their performance is relevant
+    const auto corpus = fake::make_corpus();
+    if (!golden_path.empty()) {
+        fake::golden_results golden;
+        if (!fake::read_golden(golden_path, golden)) {
+            std::cerr << "ERROR: Failed to read golden results " << golden_path << "\n";
+            return EXIT_FAILURE;
+        }
+
+        if (!fake::verify_corpus(corpus, golden, std::cerr)) {
+            std::cerr << "ERROR: Corpus does not match golden results " << golden_path << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    // A Mali-G710 with 10 cores, reported by each kernel driver type
+    const uint32_t product_id { 0xa002 };
+    const uint32_t num_cores { 10 };
+
+    auto pre_r21 = fake::make_gpu(fake::kernel_type::pre_r21, product_id, num_cores);
+    auto post_r21_jm = fake::make_gpu(fake::kernel_type::post_r21_jm, product_id, num_cores);
+    auto post_r21_csf = fake::make_gpu(fake::kernel_type::post_r21_csf, product_id, num_cores);
+
+    // A property buffer from a newer driver, exceeding the on-stack buffer
+    auto oversized = post_r21_jm;
+    oversized.num_unknown_props = 1024;
+
+    // The reference is run first and last, and the faster run is kept, so
+    // that it reflects the machine state over the whole benchmark run
+    std::vector<result> results;
+    results.push_back(bench_reference());
+    results.push_back(bench_lookup_catalog());
+    results.push_back(bench_lookup_unknown());
+    results.push_back(bench_lookup_batch());
+    results.push_back(bench_decode("decode_realistic", post_r21_jm));
+    results.push_back(bench_decode("decode_oversized", oversized));
+    results.push_back(bench_decode_corpus(corpus));
+    results.push_back(bench_generate_population());
+
+    // Instances can only be created for the backends included in the build
+    if (fake::is_kernel_enabled(fake::kernel_type::pre_r21)) {
+        results.push_back(bench_create("create_pre_r21", pre_r21));
+    }
+
+    if (fake::is_kernel_enabled(fake::kernel_type::post_r21_jm)) {
+        results.push_back(bench_create("create_post_r21_jm", post_r21_jm));
+    }
+
+    if (fake::is_kernel_enabled(fake::kernel_type::post_r21_csf)) {
+        results.push_back(bench_create("create_post_r21_csf", post_r21_csf));
+    }
+
+    if (fake::is_kernel_enabled(oversized.kernel)) {
+        results.push_back(bench_create("create_oversized", oversized));
+    }
+
+    const result last_reference = bench_reference();
+    if (last_reference.ns_per_op < results[0].ns_per_op) {
+        results[0] = last_reference;
+    }
+
+    if (output_path.empty()) {
+        write_json(std::cout, results);
+    } else {
+        std::ofstream out(output_path);
+        write_json(out, results);
+        if (!out) {
+            std::cerr << "ERROR: Failed to write " << output_path << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!baseline_path.empty()) {
+        std::map<std::string, double> baseline;
+        std::string baseline_level;
+        if (!read_json(baseline_path, baseline, baseline_level)) {
+            std::cerr << "ERROR: Failed to read baseline " << baseline_path << "\n";
+            return EXIT_FAILURE;
+        }
+
+        if (baseline_level != optimization) {
+            std::cerr << "Not comparing against " << baseline_path << ", which was recorded with optimization level "
+                      << baseline_level << ", not " << optimization << "\n";
+        } else {
+            std::cerr << "Comparing against " << baseline_path << ":\n";
+            if (!compare(results, baseline, tolerance)) {
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Checks of the C interface, built as C.
+ *
+ * Usage:
+ *
+ *     libgpuinfo_capi
+ *
+ * Checks the result structure versioning and argument validation of the C
+ * interface, using product lookups that do not need a kernel driver. Failed
+ * checks are reported to stderr, and the exit code is non-zero if any check
+ * failed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libgpuinfo_c.h"
+
+/** The number of failed checks. */
+static int num_failures = 0;
+
+/** Report a failed check. */
+static void check(int pass, const char* description)
+{
+    if (!pass)
+    {
+        fprintf(stderr, "FAIL: %s\n", description);
+        num_failures++;
+    }
+}
+
+/** Check a product lookup into a full size result structure. */
+static void check_product_info(void)
+{
+    libarmgpuinfo_info info;
+    memset(&info, 0, sizeof(info));
+    info.struct_size = sizeof(info);
+
+    libarmgpuinfo_result result = libarmgpuinfo_get_product_info(0xa002, 10, 0, 0, &info);
+    check(result == LIBARMGPUINFO_SUCCESS, "Product lookup succeeds");
+    check(info.struct_size == sizeof(info), "Product lookup keeps the structure size");
+    check(info.struct_version == LIBARMGPUINFO_INFO_VERSION, "Product lookup reports the current version");
+    check(info.gpu_id == 0xa002, "Product lookup reports the GPU ID");
+    check(info.gpu_name && (strcmp(info.gpu_name, "Mali-G710") == 0), "Product lookup reports the GPU name");
+    check(info.num_shader_cores == 10, "Product lookup reports the core count");
+    check(info.num_fp32_fmas_per_cy != 0, "Product lookup reports the FMA rate");
+    check(info.topology.num_groups == 1, "Product lookup reports a single core group");
+    check(info.topology.groups[0].core_mask == 0x3ff, "Product lookup reports the core group mask");
+    check(info.topology.groups[0].num_cores == 10, "Product lookup reports the core group size");
+    check(info.num_threads_per_core != 0, "Product lookup reports the thread count");
+    check(info.tiler.num_prims_per_cy != 0, "Product lookup reports the tiler rate");
+}
+
+/** Check that results are only written within the caller's structure size. */
+static void check_struct_size(void)
+{
+    libarmgpuinfo_info info;
+    unsigned char* bytes = (unsigned char*)&info;
+
+    memset(&info, 0xa5, sizeof(info));
+    info.struct_size = LIBARMGPUINFO_INFO_SIZE_V1;
+
+    libarmgpuinfo_result result = libarmgpuinfo_get_product_info(0xa002, 10, 0, 0, &info);
+    check(result == LIBARMGPUINFO_SUCCESS, "Version 1 size lookup succeeds");
+    check(info.struct_version == 1, "Version 1 size lookup reports version 1");
+    check(info.num_pixels_per_cy != 0xa5a5a5a5, "Version 1 size lookup writes the last version 1 field");
+
+    size_t i;
+    int untouched = 1;
+    for (i = LIBARMGPUINFO_INFO_SIZE_V1; i < sizeof(info); i++)
+    {
+        untouched = untouched && (bytes[i] == 0xa5);
+    }
+
+    check(untouched, "Version 1 size lookup does not write past the version 1 fields");
+
+    memset(&info, 0xa5, sizeof(info));
+    info.struct_size = LIBARMGPUINFO_INFO_SIZE_V2 - 1;
+    result = libarmgpuinfo_get_product_info(0xa002, 10, 0, 0, &info);
+    check(result == LIBARMGPUINFO_SUCCESS, "Partial version 2 size lookup succeeds");
+    check(info.struct_version == 1, "Partial version 2 size lookup reports version 1");
+
+    info.struct_size = LIBARMGPUINFO_INFO_SIZE_V1 - 1;
+    result = libarmgpuinfo_get_product_info(0xa002, 10, 0, 0, &info);
+    check(result == LIBARMGPUINFO_ERROR_STRUCT_TOO_SMALL, "Undersized structure is rejected");
+
+    result = libarmgpuinfo_get_product_info(0xa002, 10, 0, 0, NULL);
+    check(result == LIBARMGPUINFO_ERROR_INVALID_ARGUMENT, "Missing structure is rejected");
+}
+
+/** Check that a batch stride that would misalign elements is rejected. */
+static void check_batch_alignment(void)
+{
+    libarmgpuinfo_info infos[3];
+    const uint32_t device_ids[2] = { 0, 1 };
+    libarmgpuinfo_result results[2] = { LIBARMGPUINFO_SUCCESS, LIBARMGPUINFO_SUCCESS };
+
+    memset(infos, 0, sizeof(infos));
+    infos[0].struct_size = sizeof(infos[0]) + 1;
+
+    libarmgpuinfo_result result = libarmgpuinfo_query_batch(device_ids, 2, infos, results);
+    check(result == LIBARMGPUINFO_ERROR_STRUCT_MISALIGNED, "Misaligned batch stride is rejected");
+    check((results[0] == LIBARMGPUINFO_SUCCESS) && (results[1] == LIBARMGPUINFO_SUCCESS),
+          "Misaligned batch stride does not query any device");
+
+    const char* description = libarmgpuinfo_result_string(LIBARMGPUINFO_ERROR_STRUCT_MISALIGNED);
+    check(strcmp(description, "Unknown result") != 0, "Misaligned result has a description");
+}
+
+int main(void)
+{
+    check_product_info();
+    check_struct_size();
+    check_batch_alignment();
+
+    if (num_failures)
+    {
+        return EXIT_FAILURE;
+    }
+
+    printf("PASS\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Generator and verifier for the synthetic device corpus.
+ *
+ * Usage:
+ *
+ *     libgpuinfo_corpus --verify <golden file>
+ *     libgpuinfo_corpus --write-golden <golden file>
+ *     libgpuinfo_corpus --write-captures <directory>
+ *
+ * The verify mode checks every corpus case against the golden results, using
+ * both a full query via the fake kernel driver and offline capture decoding.
+ * The write modes regenerate the golden results from the current library, or
+ * write each case as a capture file for use with other tools.
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "fake_driver/libgpuinfo_corpus.hpp"
+
+using namespace libarmgpuinfo;
+
+namespace {
+
+/** Write each corpus case as a capture file. */
+bool write_captures(const std::string& dir, const std::vector<fake::corpus_case>& corpus)
+{
+    for (const auto& test : corpus) {
+        const std::string path = dir + "/" + test.name + ".mgpc";
+        const auto capture = fake::encode_capture(test.gpu);
+
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(capture.data()), capture.size());
+        if (!out) {
+            std::cerr << "ERROR: Failed to write " << path << "\n";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3) {
+        std::cerr << "Usage: libgpuinfo_corpus --verify|--write-golden|--write-captures <path>\n";
+        return EXIT_FAILURE;
+    }
+
+    const std::string mode { argv[1] };
+    const std::string path { argv[2] };
+    const auto corpus = fake::make_corpus();
+
+    if (mode == "--verify") {
+        fake::golden_results golden;
+        if (!fake::read_golden(path, golden)) {
+            std::cerr << "ERROR: Failed to read " << path << "\n";
+            return EXIT_FAILURE;
+        }
+
+        if (!fake::verify_corpus(corpus, golden, std::cerr)) {
+            std::cerr << "FAIL: Corpus does not match " << path << "\n";
+            return EXIT_FAILURE;
+        }
+
+        std::cout << "PASS: " << corpus.size() << " corpus cases match " << path << "\n";
+        return EXIT_SUCCESS;
+    }
+
+    if (mode == "--write-golden") {
+        std::ofstream out(path);
+        if (!fake::write_golden(out, corpus)) {
+            std::cerr << "ERROR: Failed to write " << path << "\n";
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    if (mode == "--write-captures") {
+        return write_captures(path, corpus) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    std::cerr << "ERROR: Unknown mode " << mode << "\n";
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,577 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "libgpuinfo_products.hpp"
+#include "fake_driver/libgpuinfo_corpus.hpp"
+
+namespace libarmgpuinfo {
+namespace fake {
+
+namespace {
+
+/** Products with multiple core group configurations. */
+constexpr uint32_t T600 { 0x6956 };
+constexpr uint32_t T620 { 0x0620 };
+
+/** Products with IO coherent configurations. */
+constexpr uint32_t G710 { 0xa002 };
+
+/** Products with configuration-dependent performance, and their variants. */
+constexpr uint32_t G51 { 0x7000 };
+constexpr uint32_t G52 { 0x7002 };
+constexpr uint32_t G31 { 0x7003 };
+constexpr uint32_t G510 { 0xa003 };
+constexpr uint32_t G310 { 0xa004 };
+
+/** Number of G510 and G310 core_features variants, including one reserved value. */
+constexpr uint32_t num_g510_variants { 8 };
+
+/** THREAD_FEATURES value of a G31 or G51 single-engine configuration. */
+constexpr uint32_t single_engine_thread_features { 0x2000 };
+
+/** The kernel driver interfaces, and their case name suffixes. */
+const std::pair<kernel_type, const char*> kernels[] {
+    { kernel_type::pre_r21, "pre_r21" },
+    { kernel_type::post_r21_jm, "jm" },
+    { kernel_type::post_r21_csf, "csf" }
+};
+
+/** COHERENCY_ENABLE value when the GPU is not coherent. */
+constexpr uint32_t no_coherency { 31 };
+
+/** Configuration of a product, beyond its core count. */
+struct variant {
+    /** The CORE_FEATURES register value. */
+    uint32_t core_features { 0 };
+    /** The THREAD_FEATURES register value. */
+    uint32_t thread_features { 0 };
+    /** The number of core groups. */
+    uint32_t num_groups { 1 };
+    /** The selected COHERENCY_ENABLE value. */
+    uint32_t coherency_mode { no_coherency };
+};
+
+/** Builder that adds each product configuration once, for every kernel. */
+class corpus_builder {
+  public:
+    void add(uint32_t product_id, uint32_t num_cores, const variant& config=variant {})
+    {
+        // Default configuration options are omitted from the name
+        char options[32] { 0 };
+        int length { 0 };
+        if (config.num_groups > 1) {
+            length += snprintf(options + length, sizeof(options) - length, "_g%u", config.num_groups);
+        }
+
+        if (config.coherency_mode != no_coherency) {
+            length += snprintf(options + length, sizeof(options) - length, "_coh%u", config.coherency_mode);
+        }
+
+        char base[64];
+        snprintf(base, sizeof(base), "%04x_%uc_cf%x_tf%x%s",
+                 product_id, num_cores, config.core_features, config.thread_features, options);
+        if (!seen_.insert(base).second) {
+            return;
+        }
+
+        for (const auto& kernel : kernels) {
+            std::string name = std::string(base) + "_" + kernel.second;
+
+            auto gpu = make_gpu(kernel.first, product_id, num_cores,
+                                config.core_features, config.thread_features);
+            gpu.num_core_groups = config.num_groups;
+            gpu.coherency_mode = config.coherency_mode;
+            corpus_.push_back({ name, gpu });
+        }
+    }
+
+    std::vector<corpus_case> take()
+    {
+        return std::move(corpus_);
+    }
+
+  private:
+    std::set<std::string> seen_;
+    std::vector<corpus_case> corpus_;
+};
+
+/**
+ * Separator before the formatted information that is only available from a
+ * device query, because captures do not store the CSF firmware interface.
+ */
+constexpr const char* query_only_separator { " | " };
+
+/** Remove the query-only information from a formatted result. */
+std::string strip_query_only(
+    const std::string& line
+) {
+    return line.substr(0, line.find(query_only_separator));
+}
+
+/** Query a fake device via the fake kernel driver. */
+bool query_device(
+    const fake_gpu& gpu,
+    gpuinfo& info
+) {
+    remove_devices();
+    install_device(gpu);
+    auto inst = instance::create(0, get_driver());
+
+    // The kbase context must be released before create() returns
+    const bool detached = get_driver().memory_usage(0) == 0;
+    remove_devices();
+
+    if (!inst || !detached || (inst->get_released_kernel_bytes() != gpu.context_bytes)) {
+        return false;
+    }
+
+    info = inst->get_info();
+    return true;
+}
+
+/** Storage for the result columns of a batch query. */
+struct batch_storage {
+    explicit batch_storage(std::size_t count)
+        : gpu_id(count), gpu_name(count), architecture_name(count),
+          architecture_major(count), architecture_minor(count),
+          num_shader_cores(count), shader_core_mask(count), num_l2_slices(count),
+          num_l2_bytes(count), num_bus_bits(count), num_exec_engines(count),
+          num_fp32_fmas_per_cy(count), num_fp16_fmas_per_cy(count),
+          num_int8_macs_per_cy(count), num_fp16_macs_per_cy(count),
+          num_texels_per_cy(count), num_pixels_per_cy(count),
+          num_tiler_prims_per_cy(count), num_threads_per_core(count) {}
+
+    /** @return The result columns. */
+    gpuinfo_columns columns() {
+        return {
+            gpu_id.data(), gpu_name.data(), architecture_name.data(),
+            architecture_major.data(), architecture_minor.data(),
+            num_shader_cores.data(), shader_core_mask.data(), num_l2_slices.data(),
+            num_l2_bytes.data(), num_bus_bits.data(), num_exec_engines.data(),
+            num_fp32_fmas_per_cy.data(), num_fp16_fmas_per_cy.data(),
+            num_int8_macs_per_cy.data(), num_fp16_macs_per_cy.data(),
+            num_texels_per_cy.data(), num_pixels_per_cy.data(),
+            num_tiler_prims_per_cy.data(), num_threads_per_core.data()
+        };
+    }
+
+    /** @return A row, as GPU information with only the column fields set. */
+    gpuinfo get_row(std::size_t row) const {
+        gpuinfo info {};
+        info.gpu_id = gpu_id[row];
+        info.gpu_name = gpu_name[row];
+        info.architecture_name = architecture_name[row];
+        info.architecture_major = architecture_major[row];
+        info.architecture_minor = architecture_minor[row];
+        info.num_shader_cores = num_shader_cores[row];
+        info.shader_core_mask = shader_core_mask[row];
+        info.num_l2_slices = num_l2_slices[row];
+        info.num_l2_bytes = num_l2_bytes[row];
+        info.num_bus_bits = num_bus_bits[row];
+        info.num_exec_engines = num_exec_engines[row];
+        info.num_fp32_fmas_per_cy = num_fp32_fmas_per_cy[row];
+        info.num_fp16_fmas_per_cy = num_fp16_fmas_per_cy[row];
+        info.num_int8_macs_per_cy = num_int8_macs_per_cy[row];
+        info.num_fp16_macs_per_cy = num_fp16_macs_per_cy[row];
+        info.num_texels_per_cy = num_texels_per_cy[row];
+        info.num_pixels_per_cy = num_pixels_per_cy[row];
+        info.tiler.num_prims_per_cy = num_tiler_prims_per_cy[row];
+        info.num_threads_per_core = num_threads_per_core[row];
+        return info;
+    }
+
+    std::vector<uint32_t> gpu_id;
+    std::vector<const char*> gpu_name;
+    std::vector<const char*> architecture_name;
+    std::vector<uint32_t> architecture_major;
+    std::vector<uint32_t> architecture_minor;
+    std::vector<uint32_t> num_shader_cores;
+    std::vector<uint64_t> shader_core_mask;
+    std::vector<uint32_t> num_l2_slices;
+    std::vector<uint32_t> num_l2_bytes;
+    std::vector<uint32_t> num_bus_bits;
+    std::vector<uint32_t> num_exec_engines;
+    std::vector<uint32_t> num_fp32_fmas_per_cy;
+    std::vector<uint32_t> num_fp16_fmas_per_cy;
+    std::vector<uint32_t> num_int8_macs_per_cy;
+    std::vector<uint32_t> num_fp16_macs_per_cy;
+    std::vector<uint32_t> num_texels_per_cy;
+    std::vector<uint32_t> num_pixels_per_cy;
+    std::vector<uint32_t> num_tiler_prims_per_cy;
+    std::vector<uint32_t> num_threads_per_core;
+};
+
+/** @return GPU information with only the batch column fields copied. */
+gpuinfo get_batch_fields(
+    const gpuinfo& info
+) {
+    gpuinfo fields {};
+    fields.gpu_id = info.gpu_id;
+    fields.gpu_name = info.gpu_name;
+    fields.architecture_name = info.architecture_name;
+    fields.architecture_major = info.architecture_major;
+    fields.architecture_minor = info.architecture_minor;
+    fields.num_shader_cores = info.num_shader_cores;
+    fields.shader_core_mask = info.shader_core_mask;
+    fields.num_l2_slices = info.num_l2_slices;
+    fields.num_l2_bytes = info.num_l2_bytes;
+    fields.num_bus_bits = info.num_bus_bits;
+    fields.num_exec_engines = info.num_exec_engines;
+    fields.num_fp32_fmas_per_cy = info.num_fp32_fmas_per_cy;
+    fields.num_fp16_fmas_per_cy = info.num_fp16_fmas_per_cy;
+    fields.num_int8_macs_per_cy = info.num_int8_macs_per_cy;
+    fields.num_fp16_macs_per_cy = info.num_fp16_macs_per_cy;
+    fields.num_texels_per_cy = info.num_texels_per_cy;
+    fields.num_pixels_per_cy = info.num_pixels_per_cy;
+    fields.tiler.num_prims_per_cy = info.tiler.num_prims_per_cy;
+    fields.num_threads_per_core = info.num_threads_per_core;
+    return fields;
+}
+
+/** Check a batch result row against the result of a single query. */
+bool check_batch_row(
+    const std::string& name,
+    const gpuinfo& expected,
+    const batch_storage& storage,
+    std::size_t row,
+    std::ostream& log
+) {
+    const std::string expected_line = format_info(get_batch_fields(expected));
+    const std::string actual_line = format_info(storage.get_row(row));
+    if (expected_line != actual_line) {
+        log << name << ": batch mismatch\n"
+            << "    expected: " << expected_line << "\n"
+            << "    actual:   " << actual_line << "\n";
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Verify the batch queries against single queries.
+ *
+ * Captures are checked against decode_capture(). Product configurations are
+ * checked against get_product_info(), for each corpus case and for a sweep
+ * of every catalog ID, some unknown IDs, and a range of core counts, which
+ * spans several batch tiles.
+ */
+bool verify_batch(
+    const std::vector<corpus_case>& corpus,
+    std::ostream& log
+) {
+    bool pass { true };
+
+    std::vector<std::vector<unsigned char>> captures;
+    std::vector<const void*> capture_data;
+    std::vector<std::size_t> capture_sizes;
+    for (const auto& test : corpus) {
+        captures.push_back(encode_capture(test.gpu));
+    }
+
+    for (const auto& capture : captures) {
+        capture_data.push_back(capture.data());
+        capture_sizes.push_back(capture.size());
+    }
+
+    batch_storage decoded_storage { corpus.size() };
+    std::unique_ptr<bool[]> decoded { new bool[corpus.size()] };
+    decode_capture_batch(capture_data.data(), capture_sizes.data(), corpus.size(),
+                         decoded_storage.columns(), decoded.get());
+
+    for (std::size_t i = 0; i < corpus.size(); i++) {
+        gpuinfo info {};
+        const bool ok = decode_capture(captures[i].data(), captures[i].size(), info);
+        pass = (decoded[i] == ok) && pass;
+        pass = check_batch_row(corpus[i].name, info, decoded_storage, i, log) && pass;
+    }
+
+    std::vector<uint32_t> product_ids;
+    std::vector<uint32_t> core_counts;
+    std::vector<uint32_t> core_features;
+    std::vector<uint32_t> thread_features;
+    for (const auto& test : corpus) {
+        product_ids.push_back(static_cast<uint32_t>(test.gpu.raw_gpu_id >> 16));
+        core_counts.push_back(static_cast<uint32_t>(__builtin_popcountll(test.gpu.shader_present)));
+        core_features.push_back(test.gpu.core_features);
+        thread_features.push_back(test.gpu.thread_features);
+    }
+
+    std::vector<uint32_t> sweep_ids { 0x0000, 0x1234, 0xa013, 0xffff };
+    for (const auto& entry : detail::PRODUCT_VERSIONS) {
+        sweep_ids.push_back(entry.id);
+    }
+
+    for (uint32_t id : sweep_ids) {
+        for (uint32_t cores = 0; cores <= 16; cores++) {
+            product_ids.push_back(id);
+            core_counts.push_back(cores);
+            core_features.push_back(cores);
+            thread_features.push_back((cores & 1) ? single_engine_thread_features : 0);
+        }
+    }
+
+    const std::size_t count = product_ids.size();
+    batch_storage product_storage { count };
+    const product_config_columns configs {
+        product_ids.data(), core_counts.data(), core_features.data(), thread_features.data() };
+    get_product_info_batch(configs, count, product_storage.columns());
+
+    for (std::size_t i = 0; i < count; i++) {
+        const gpuinfo info = get_product_info(
+            product_ids[i], core_counts[i], core_features[i], thread_features[i]);
+        const std::string name = (i < corpus.size()) ? corpus[i].name : ("sweep " + std::to_string(i));
+        pass = check_batch_row(name, info, product_storage, i, log) && pass;
+    }
+
+    return pass;
+}
+
+}
+
+/* See header for documentation */
+std::vector<corpus_case> make_corpus()
+{
+    corpus_builder builder;
+
+    // Every catalog entry at its minimum core count, and just below it
+    for (const auto& entry : detail::PRODUCT_VERSIONS) {
+        builder.add(entry.id, entry.min_cores);
+        if (entry.min_cores > 1) {
+            builder.add(entry.id, entry.min_cores - 1);
+        }
+    }
+
+    // Every G510 and G310 core variant
+    for (uint32_t variant = 0; variant < num_g510_variants; variant++) {
+        builder.add(G510, 4, { variant });
+        builder.add(G310, 4, { variant });
+    }
+
+    // G52 engine count variants
+    builder.add(G52, 2, { 1 });
+    builder.add(G52, 2, { 2 });
+
+    // G31 and G51 single-engine configurations, which only apply to one core
+    for (uint32_t product_id : { G31, G51 }) {
+        builder.add(product_id, 1, { 0, single_engine_thread_features });
+        builder.add(product_id, 2, { 0, single_engine_thread_features });
+    }
+
+    // Multiple core group configurations
+    builder.add(T600, 8, { 0, 0, 2 });
+    builder.add(T620, 6, { 0, 0, 2 });
+    builder.add(G510, 6, { 0, 0, 3 });
+
+    // IO coherent configurations, using ACE-Lite and ACE
+    builder.add(G710, 10, { 0, 0, 1, 0 });
+    builder.add(G710, 10, { 0, 0, 1, 1 });
+
+    return builder.take();
+}
+
+/* See header for documentation */
+std::string format_info(
+    const gpuinfo& info
+) {
+    // Core groups are formatted as mask:l2_index pairs
+    std::string groups;
+    for (uint32_t i = 0; i < info.topology.num_groups; i++) {
+        char group[32];
+        snprintf(group, sizeof(group), "%s0x%llx:%u", i ? "," : "",
+                 static_cast<unsigned long long>(info.topology.groups[i].core_mask),
+                 info.topology.groups[i].l2_index);
+        groups += group;
+    }
+
+    // Occupancy of a shader past the first register cliff on every architecture
+    const auto occupancy = get_shader_occupancy(info, { 40, 0, 0 });
+
+    char line[1024];
+    snprintf(line, sizeof(line),
+             "name=\"%s\" arch=\"%s\" id=0x%04x version=%u.%u cores=%u mask=0x%llx "
+             "l2=%llu slices=%u slice=%u line=%u bus=%u engines=%u fp32=%u fp16=%u i8dot=%u f16dot=%u texels=%u pixels=%u "
+             "l2s=%u groups=%s tex=0x%x coherency=%u/0x%x mem=%llu va=%u pa=%u as=%u "
+             "sched=%u js=%u/%u/%u tiler=0x%x/%u/%u/%u threads=%u regs=%u occ40=%u/%u/%u"
+             "%scsf=0x%x/%u/%u",
+             info.gpu_name ? info.gpu_name : "",
+             info.architecture_name ? info.architecture_name : "",
+             info.gpu_id,
+             info.architecture_major,
+             info.architecture_minor,
+             info.num_shader_cores,
+             static_cast<unsigned long long>(info.shader_core_mask),
+             static_cast<unsigned long long>(info.num_l2_bytes),
+             info.num_l2_slices,
+             info.num_l2_slice_bytes,
+             info.num_l2_line_bytes,
+             info.num_bus_bits,
+             info.num_exec_engines,
+             info.num_fp32_fmas_per_cy,
+             info.num_fp16_fmas_per_cy,
+             info.num_int8_macs_per_cy,
+             info.num_fp16_macs_per_cy,
+             info.num_texels_per_cy,
+             info.num_pixels_per_cy,
+             info.topology.num_l2_caches,
+             groups.c_str(),
+             info.texture_formats,
+             static_cast<uint32_t>(info.coherency),
+             info.coherency_protocols,
+             static_cast<unsigned long long>(info.num_gpu_memory_bytes),
+             info.num_va_bits,
+             info.num_pa_bits,
+             info.num_address_spaces,
+             static_cast<uint32_t>(info.queues.scheduler),
+             info.queues.num_job_slots,
+             info.queues.num_compute_slots,
+             info.queues.num_fragment_slots,
+             info.tiler.tiler_features,
+             info.tiler.bin_size_bytes,
+             info.tiler.max_active_levels,
+             info.tiler.num_prims_per_cy,
+             info.num_threads_per_core,
+             info.num_registers_per_core,
+             occupancy.num_threads,
+             occupancy.occupancy_percent,
+             occupancy.num_cliff_registers,
+             query_only_separator,
+             info.queues.csf_interface_version,
+             info.queues.num_queue_groups,
+             info.queues.num_queues_per_group);
+
+    return line;
+}
+
+/* See header for documentation */
+bool write_golden(
+    std::ostream& out,
+    const std::vector<corpus_case>& corpus
+) {
+    out << "# libGPUInfo synthetic corpus golden results.\n";
+    out << "# Regenerate with: libgpuinfo_corpus --write-golden <file>\n";
+
+    for (const auto& test : corpus) {
+        gpuinfo info {};
+        if (!query_device(test.gpu, info)) {
+            return false;
+        }
+
+        out << test.name << ": " << format_info(info) << "\n";
+    }
+
+    return static_cast<bool>(out);
+}
+
+/* See header for documentation */
+bool read_golden(
+    const std::string& path,
+    golden_results& golden
+) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || (line[0] == '#')) {
+            continue;
+        }
+
+        auto split = line.find(": ");
+        if (split == std::string::npos) {
+            return false;
+        }
+
+        golden[line.substr(0, split)] = line.substr(split + 2);
+    }
+
+    return true;
+}
+
+/* See header for documentation */
+bool verify_corpus(
+    const std::vector<corpus_case>& corpus,
+    const golden_results& golden,
+    std::ostream& log
+) {
+    bool pass { true };
+
+    if (golden.size() != corpus.size()) {
+        log << "Golden results have " << golden.size() << " cases, corpus has "
+            << corpus.size() << " cases\n";
+        pass = false;
+    }
+
+    for (const auto& test : corpus) {
+        auto it = golden.find(test.name);
+        if (it == golden.end()) {
+            log << test.name << ": no golden result\n";
+            pass = false;
+            continue;
+        }
+
+        // Full query via the fake kernel driver, which fails if the backend
+        // for the kernel driver interface is excluded from the build
+        gpuinfo queried_info {};
+        std::string queried = query_device(test.gpu, queried_info) ?
+            format_info(queried_info) : "query failed";
+        const std::string expected_query = is_kernel_enabled(test.gpu.kernel) ?
+            it->second : "query failed";
+        if (queried != expected_query) {
+            log << test.name << ": query mismatch\n"
+                << "    expected: " << expected_query << "\n"
+                << "    actual:   " << queried << "\n";
+            pass = false;
+        }
+
+        // Offline decode of the capture
+        gpuinfo info {};
+        const auto capture = encode_capture(test.gpu);
+        std::string decoded = decode_capture(capture.data(), capture.size(), info) ?
+            strip_query_only(format_info(info)) : "decode failed";
+        std::string expected = strip_query_only(it->second);
+        if (decoded != expected) {
+            log << test.name << ": capture mismatch\n"
+                << "    expected: " << expected << "\n"
+                << "    actual:   " << decoded << "\n";
+            pass = false;
+        }
+    }
+
+    return verify_batch(corpus, log) && pass;
+}
+
+}
+}
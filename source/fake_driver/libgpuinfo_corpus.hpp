@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief The synthetic device corpus.
+ *
+ * The corpus is a set of fake devices that covers every product catalog entry
+ * at each shader core count boundary, each configuration-dependent product
+ * variant, and multiple core group configurations, reported by each kernel
+ * driver interface. Each case has a
+ * golden expected result, stored as a line of text so that changes are easy
+ * to review.
+ */
+
+#pragma once
+
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "libgpuinfo.hpp"
+#include "fake_driver/libgpuinfo_fake_driver.hpp"
+
+namespace libarmgpuinfo {
+namespace fake {
+
+/** A single corpus case. */
+struct corpus_case {
+    /** The unique case name. */
+    std::string name;
+
+    /** The fake GPU description. */
+    fake_gpu gpu;
+};
+
+/** Golden results, indexed by case name. */
+using golden_results = std::map<std::string, std::string>;
+
+/** @return The corpus cases, in a stable order. */
+std::vector<corpus_case> make_corpus();
+
+/**
+ * Format a result as a single line of text, excluding the case name.
+ *
+ * @param info   The GPU information.
+ *
+ * @return The formatted result.
+ */
+std::string format_info(
+    const gpuinfo& info);
+
+/**
+ * Write golden results for a corpus, using the fake kernel driver.
+ *
+ * Every case is queried, so the library must include all of the kernel
+ * driver backends.
+ * @param out      The output stream.
+ * @param corpus   The corpus cases.
+ *
+ * @return @c true if every case was queried, @c false otherwise.
+ */
+bool write_golden(
+    std::ostream& out,
+    const std::vector<corpus_case>& corpus);
+
+/**
+ * Read golden results written by @c write_golden().
+ *
+ * @param path     The golden file path.
+ * @param golden   The returned golden results.
+ *
+ * @return @c true if the file was read, @c false otherwise.
+ */
+bool read_golden(
+    const std::string& path,
+    golden_results& golden);
+
+/**
+ * Verify a corpus against golden results.
+ *
+ * Each case is checked both via a full instance query using the fake kernel
+ * driver, and via offline decoding of its capture. Captures do not store the
+ * CSF firmware interface, so the information that follows the " | "
+ * separator is only checked for the query. The batch queries are also
+ * checked against the single queries. Queries of cases whose kernel driver
+ * backend is excluded from the build are expected to fail, but their
+ * captures are still decoded. Mismatches are reported to the log stream.
+ *
+ * @param corpus   The corpus cases.
+ * @param golden   The golden results.
+ * @param log      The stream for mismatch reports.
+ *
+ * @return @c true if every case matches, @c false otherwise.
+ */
+bool verify_corpus(
+    const std::vector<corpus_case>& corpus,
+    const golden_results& golden,
+    std::ostream& log);
+
+}
+}
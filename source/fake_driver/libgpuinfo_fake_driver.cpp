@@ -0,0 +1,669 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <set>
+#include <utility>
+
+#include <sys/stat.h>
+
+#include "libgpuinfo.hpp"
+#include "libgpuinfo_capture.hpp"
+#include "libgpuinfo_decoder.hpp"
+#include "libgpuinfo_device.hpp"
+#include "fake_driver/libgpuinfo_fake_driver.hpp"
+
+namespace libarmgpuinfo {
+namespace fake {
+
+namespace {
+
+/** Size of a property value, as encoded in the bottom bits of the key. */
+enum prop_size : uint32_t {
+    u8 = 0,
+    u16 = 1,
+    u32 = 2,
+    u64 = 3
+};
+
+/** A property reported by the post-r21 kernel drivers. */
+struct prop_info {
+    /** The property code. */
+    uint32_t code;
+    /** The property value size. */
+    prop_size size;
+};
+
+/** The properties reported by a current kbase driver, in reporting order. */
+constexpr prop_info POST_R21_PROPS[] {
+    {  1, u32 }, {  2, u16 }, {  3, u16 }, {  4, u16 }, {  6, u64 }, {  8, u8  },
+    {  9, u32 }, { 10, u32 }, { 11, u32 }, { 80, u32 }, { 12, u64 }, { 13, u8  },
+    { 14, u8  }, { 15, u8  }, { 16, u32 }, { 17, u32 }, { 18, u32 }, { 19, u32 },
+    { 20, u32 }, { 21, u16 }, { 22, u8  }, { 23, u8  }, { 24, u8  }, { 84, u32 },
+    { 25, u64 }, { 26, u64 }, { 27, u64 }, { 28, u64 }, { 29, u32 }, { 30, u32 },
+    { 31, u32 }, { 32, u32 }, { 33, u32 }, { 34, u32 }, { 35, u32 }, { 36, u32 },
+    { 37, u32 }, { 38, u32 }, { 39, u32 }, { 40, u32 }, { 41, u32 }, { 42, u32 },
+    { 43, u32 }, { 44, u32 }, { 45, u32 }, { 46, u32 }, { 47, u32 }, { 48, u32 },
+    { 49, u32 }, { 50, u32 }, { 51, u32 }, { 52, u32 }, { 53, u32 }, { 54, u32 },
+    { 81, u32 }, { 55, u64 }, { 56, u32 }, { 57, u32 }, { 58, u32 }, { 59, u32 },
+    { 83, u32 }, { 60, u32 }, { 85, u64 }, { 61, u32 }, { 62, u32 }, { 63, u32 },
+    { 64, u64 }, { 65, u64 }, { 66, u64 }, { 67, u64 }, { 68, u64 }, { 69, u64 },
+    { 70, u64 }, { 71, u64 }, { 72, u64 }, { 73, u64 }, { 74, u64 }, { 75, u64 },
+    { 76, u64 }, { 77, u64 }, { 78, u64 }, { 79, u64 }, { 82, u8  }
+};
+
+/** The first property code not used by current kbase drivers. */
+constexpr uint32_t first_unknown_prop { 86 };
+
+/** The number of unknown property codes that can be generated. */
+constexpr uint32_t num_unknown_codes { 256 - first_unknown_prop };
+
+/** Typical register values for properties that are not described by fake_gpu. */
+constexpr uint32_t default_l2_features { 0x07120306 };
+constexpr uint32_t default_max_threads { 1024 };
+constexpr uint32_t default_max_workgroup { 512 };
+constexpr uint32_t default_max_barrier { 512 };
+constexpr uint32_t default_max_registers { 32768 };
+constexpr uint32_t default_mmu_features { 0x2830 };
+constexpr uint32_t default_as_present { 0xFF };
+constexpr uint32_t default_js_present { 0x7 };
+constexpr uint32_t default_csf_version { 0x03000000 };
+
+/** TILER_FEATURES value with a 512 byte bin size and 8 active levels. */
+constexpr uint32_t default_tiler_features { 0x809 };
+
+/** Typical JS_FEATURES values, for the fragment, vertex and tiler, and compute slots. */
+constexpr uint32_t default_js_features[] { 0x20e, 0x1fe, 0x7e };
+constexpr uint64_t default_available_memory { 1ULL << 32 };
+
+/** TEXTURE_FEATURES_0 value supporting ETC2, EAC, and ASTC LDR. */
+constexpr uint32_t ldr_texture_features { 0x005E001E };
+
+/** TEXTURE_FEATURES_0 value also supporting ASTC HDR. */
+constexpr uint32_t hdr_texture_features { 0x00FE001E };
+
+/**
+ * Fake file descriptor base. Each open returns a distinct descriptor, with the
+ * driver instance in the bottom bits and an open sequence number above them.
+ */
+constexpr int fd_base { 0x4000 };
+constexpr int fd_id_bits { 8 };
+constexpr int fd_id_mask { (1 << fd_id_bits) - 1 };
+constexpr int fd_sequence_mask { 0xFFFF };
+
+/** An installed fake device. */
+struct fake_device {
+    /** The fake GPU description. */
+    fake_gpu gpu;
+    /** The encoded post-r21 property buffer, if a post-r21 kernel. */
+    std::vector<unsigned char> post_r21_props;
+    /** The open file descriptors that have created a kbase context. */
+    std::set<int> contexts;
+};
+
+/** The installed fake devices, indexed by driver instance. */
+std::map<uint32_t, fake_device>& get_devices()
+{
+    static std::map<uint32_t, fake_device> devices;
+    return devices;
+}
+
+/** Get the value of a post-r21 property for a fake GPU. */
+uint64_t get_prop_value(
+    const fake_gpu& gpu,
+    uint32_t code
+) {
+    const uint32_t l2_features = gpu.l2_features ? gpu.l2_features : default_l2_features;
+
+    switch (code) {
+    case 1:
+        return gpu.raw_gpu_id >> 16;
+    case 2:
+        return (gpu.raw_gpu_id >> 0) & 0xF;
+    case 3:
+        return (gpu.raw_gpu_id >> 4) & 0xFF;
+    case 4:
+        return (gpu.raw_gpu_id >> 12) & 0xF;
+    case 8:
+        return 48;
+    case 9:
+    case 52:
+        return gpu.texture_features;
+    case 12:
+        return default_available_memory;
+    case 13:
+        return l2_features & 0xFF;
+    case 14:
+        return (l2_features >> 16) & 0xFF;
+    case 15:
+        return gpu.num_l2_slices;
+    case 16:
+        return 1U << (default_tiler_features & 0x3F);
+    case 17:
+        return (default_tiler_features >> 8) & 0xF;
+    case 18:
+    case 56:
+        return default_max_threads;
+    case 19:
+    case 57:
+        return default_max_workgroup;
+    case 20:
+    case 58:
+        return default_max_barrier;
+    case 21:
+        return default_max_registers;
+    case 22:
+        return 24;
+    case 23:
+        return 15;
+    case 24:
+        return 1;
+    case 25:
+        return gpu.shader_present;
+    case 26:
+        return 1;
+    case 27:
+        return (1ULL << gpu.num_l2_slices) - 1;
+    case 29:
+        return l2_features;
+    case 30:
+        return gpu.core_features;
+    case 32:
+        return default_mmu_features;
+    case 33:
+        return default_as_present;
+    case 34:
+        return (gpu.kernel == kernel_type::post_r21_csf) ? 0 : default_js_present;
+    case 35:
+    case 36:
+    case 37:
+        return (gpu.kernel == kernel_type::post_r21_csf) ? 0 : default_js_features[code - 35];
+    case 51:
+        return default_tiler_features;
+    case 55:
+        return gpu.raw_gpu_id;
+    case 59:
+        return gpu.thread_features;
+    case 60:
+        return gpu.coherency_mode;
+    case 61:
+    case 62:
+        return gpu.num_core_groups;
+    case 63:
+        return gpu.coherency_features;
+    case 82:
+        return 2;
+    default:
+        if ((code >= 64) && (code <= 79)) {
+            return get_group_mask(gpu, code - 64);
+        }
+        return 0;
+    }
+}
+
+/** Append a property key and value to a property buffer. */
+void write_prop(
+    std::vector<unsigned char>& buffer,
+    uint32_t code,
+    prop_size size,
+    uint64_t value
+) {
+    const uint32_t key = (code << 2) | size;
+    for (size_t b = 0; b < sizeof(key); b++) {
+        buffer.push_back(static_cast<unsigned char>(key >> (8 * b)));
+    }
+
+    const size_t value_bytes = size_t { 1 } << size;
+    for (size_t b = 0; b < value_bytes; b++) {
+        buffer.push_back(static_cast<unsigned char>(value >> (8 * b)));
+    }
+}
+
+/** Get the fake device for a file descriptor, or nullptr if not open. */
+fake_device* get_device(int fd)
+{
+    if (fd < fd_base) {
+        return nullptr;
+    }
+
+    auto& devices = get_devices();
+    auto it = devices.find(static_cast<uint32_t>((fd - fd_base) & fd_id_mask));
+    if (it == devices.end()) {
+        return nullptr;
+    }
+
+    return &it->second;
+}
+
+/** Respond to a version check request for a specific kernel type. */
+template <typename T>
+int version_check(
+    const fake_gpu& gpu,
+    kernel_type kernel,
+    void* arg
+) {
+    if (gpu.kernel != kernel) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    auto* check = static_cast<T*>(arg);
+    check->major = gpu.version_major;
+    check->minor = gpu.version_minor;
+    return 0;
+}
+
+int fake_open(const char* path, int flags)
+{
+    (void)flags;
+
+    unsigned int id { 0 };
+    char trailing { 0 };
+    if (std::sscanf(path, "/dev/mali%u%c", &id, &trailing) != 1) {
+        errno = ENOENT;
+        return -1;
+    }
+
+    const auto& devices = get_devices();
+    if ((id > static_cast<unsigned int>(fd_id_mask)) || (devices.find(id) == devices.end())) {
+        errno = ENOENT;
+        return -1;
+    }
+
+    static int sequence { 0 };
+    sequence = (sequence + 1) & fd_sequence_mask;
+    return fd_base + (sequence << fd_id_bits) + static_cast<int>(id);
+}
+
+int fake_close(int fd)
+{
+    fake_device* device = get_device(fd);
+    if (!device) {
+        errno = EBADF;
+        return -1;
+    }
+
+    // Closing the file descriptor destroys its kbase context
+    device->contexts.erase(fd);
+    return 0;
+}
+
+int fake_fstat(int fd, struct stat* buf)
+{
+    if (!get_device(fd)) {
+        errno = EBADF;
+        return -1;
+    }
+
+    std::memset(buf, 0, sizeof(*buf));
+    buf->st_mode = S_IFCHR | 0666;
+    return 0;
+}
+
+int64_t fake_memory_usage(uint32_t id)
+{
+    const auto& devices = get_devices();
+    auto it = devices.find(id);
+    if (it == devices.end()) {
+        return -1;
+    }
+
+    return static_cast<int64_t>(it->second.contexts.size() * it->second.gpu.context_bytes);
+}
+
+int fake_ioctl(int fd, unsigned long request, void* arg)
+{
+    fake_device* device = get_device(fd);
+    if (!device) {
+        errno = EBADF;
+        return -1;
+    }
+
+    const fake_gpu* gpu = &device->gpu;
+
+    switch (request) {
+    case kbase_pre_r21::version_check:
+        return version_check<kbase_pre_r21::version_check_t>(
+            *gpu, kernel_type::pre_r21, arg);
+    case kbase_post_r21::version_check_jm:
+        return version_check<kbase_post_r21::version_check_t>(
+            *gpu, kernel_type::post_r21_jm, arg);
+    case kbase_post_r21::version_check_csf:
+        return version_check<kbase_post_r21::version_check_t>(
+            *gpu, kernel_type::post_r21_csf, arg);
+    case kbase_pre_r21::set_flags:
+        if (gpu->kernel != kernel_type::pre_r21) {
+            break;
+        }
+        device->contexts.insert(fd);
+        return 0;
+    case kbase_post_r21::set_flags:
+        if (gpu->kernel == kernel_type::pre_r21) {
+            break;
+        }
+        device->contexts.insert(fd);
+        return 0;
+    case kbase_pre_r21::get_gpuprops: {
+        if (gpu->kernel != kernel_type::pre_r21) {
+            break;
+        }
+
+        auto* props = static_cast<kbase_pre_r21::uk_gpuprops_t*>(arg);
+        *props = encode_pre_r21_props(*gpu);
+        return 0;
+    }
+    case kbase_post_r21::get_gpuprops: {
+        if (gpu->kernel == kernel_type::pre_r21) {
+            break;
+        }
+
+        auto* props = static_cast<kbase_post_r21::get_gpuprops_t*>(arg);
+        const auto& buffer = device->post_r21_props;
+        const auto size = static_cast<uint32_t>(buffer.size());
+
+        // A zero size queries the required buffer size
+        if (props->size == 0) {
+            return static_cast<int>(size);
+        }
+
+        if (props->size < size) {
+            errno = EINVAL;
+            return -1;
+        }
+
+        std::memcpy(props->buffer.get(), buffer.data(), size);
+        return static_cast<int>(size);
+    }
+    case kbase_post_r21::cs_get_glb_iface: {
+        if (gpu->kernel != kernel_type::post_r21_csf) {
+            break;
+        }
+
+        auto* iface = static_cast<kbase_post_r21::cs_get_glb_iface_t*>(arg);
+        const uint32_t max_groups = iface->in.max_group_num;
+        auto* groups = iface->in.groups_ptr.get();
+        if (max_groups > kbase_post_r21::max_supported_csgs) {
+            break;
+        }
+
+        for (uint32_t i = 0; (i < max_groups) && (i < gpu->num_csf_groups); i++) {
+            groups[i] = { 0, gpu->num_csf_queues, 0, 0 };
+        }
+
+        iface->out = {};
+        iface->out.glb_version = default_csf_version;
+        iface->out.group_num = gpu->num_csf_groups;
+        iface->out.total_stream_num = gpu->num_csf_groups * gpu->num_csf_queues;
+        return 0;
+    }
+    default:
+        break;
+    }
+
+    errno = EINVAL;
+    return -1;
+}
+
+/** System call interface for the fake kernel driver. */
+constexpr driver_interface fake_driver {
+    fake_open,
+    fake_close,
+    fake_fstat,
+    fake_ioctl,
+    fake_memory_usage
+};
+
+}
+
+/* See header for documentation */
+bool is_kernel_enabled(
+    kernel_type kernel
+) {
+    switch (kernel) {
+    case kernel_type::pre_r21:
+        return detail::is_backend_enabled(detail::backend_type::pre_r21);
+    case kernel_type::post_r21_jm:
+        return detail::is_backend_enabled(detail::backend_type::post_r21_jm);
+    case kernel_type::post_r21_csf:
+        return detail::is_backend_enabled(detail::backend_type::post_r21_csf);
+    }
+
+    return false;
+}
+
+/* See header for documentation */
+fake_gpu make_gpu(
+    kernel_type kernel,
+    uint32_t product_id,
+    uint32_t num_cores,
+    uint32_t core_features,
+    uint32_t thread_features
+) {
+    fake_gpu gpu {};
+    gpu.kernel = kernel;
+    gpu.version_major = (kernel == kernel_type::pre_r21) ? 10 : 11;
+    gpu.version_minor = (kernel == kernel_type::post_r21_csf) ? 1 : 40;
+    gpu.raw_gpu_id = static_cast<uint64_t>(product_id) << 16;
+    gpu.shader_present = (num_cores >= 64) ? ~0ULL : ((1ULL << num_cores) - 1);
+    gpu.core_features = core_features;
+    gpu.thread_features = thread_features;
+
+    // Midgard products only support the LDR profile of ASTC
+    const bool is_midgard = (product_id < 0x1000) || (product_id == 0x6956);
+    gpu.texture_features = is_midgard ? ldr_texture_features : hdr_texture_features;
+    gpu.l2_features = default_l2_features;
+    gpu.num_l2_slices = (num_cores > 8) ? 2 : 1;
+    return gpu;
+}
+
+/* See header for documentation */
+uint64_t get_group_mask(
+    const fake_gpu& gpu,
+    uint32_t group
+) {
+    if (!gpu.num_core_groups || (group >= gpu.num_core_groups)) {
+        return 0;
+    }
+
+    const uint32_t num_cores = __builtin_popcountll(gpu.shader_present);
+    const uint32_t first = (num_cores * group) / gpu.num_core_groups;
+    const uint32_t last = (num_cores * (group + 1)) / gpu.num_core_groups;
+
+    uint64_t mask { 0 };
+    uint32_t index { 0 };
+    for_each_core(gpu.shader_present, [&](uint32_t core) {
+        if ((index >= first) && (index < last)) {
+            mask |= 1ULL << core;
+        }
+        index++;
+    });
+
+    return mask;
+}
+
+/* See header for documentation */
+std::vector<unsigned char> encode_post_r21_props(
+    const fake_gpu& gpu
+) {
+    struct prop_record {
+        uint32_t code;
+        prop_size size;
+        uint64_t value;
+    };
+
+    std::vector<prop_record> records;
+    for (const auto& prop : POST_R21_PROPS) {
+        records.push_back({ prop.code, prop.size, get_prop_value(gpu, prop.code) });
+    }
+
+    for (uint32_t i = 0; i < gpu.num_unknown_props; i++) {
+        const uint32_t code = first_unknown_prop + (i % num_unknown_codes);
+        records.push_back({ code, u32, i });
+    }
+
+    // Fisher-Yates shuffle, using a xorshift generator so the order is stable
+    uint32_t state = gpu.prop_order_seed;
+    for (size_t i = records.size(); state && (i > 1); i--) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        std::swap(records[i - 1], records[state % i]);
+    }
+
+    std::vector<unsigned char> buffer;
+    for (const auto& record : records) {
+        write_prop(buffer, record.code, record.size, record.value);
+    }
+
+    return buffer;
+}
+
+/* See header for documentation */
+kbase_pre_r21::uk_gpuprops_t encode_pre_r21_props(
+    const fake_gpu& gpu
+) {
+    kbase_pre_r21::uk_gpuprops_t result {};
+    auto& props = result.props;
+
+    const uint32_t l2_features = gpu.l2_features ? gpu.l2_features : default_l2_features;
+
+    props.core_props.product_id = static_cast<uint32_t>(gpu.raw_gpu_id >> 16);
+    props.core_props.version_status = get_prop_value(gpu, 2);
+    props.core_props.minor_revision = get_prop_value(gpu, 3);
+    props.core_props.major_revision = get_prop_value(gpu, 4);
+    props.core_props.log2_program_counter_size = get_prop_value(gpu, 8);
+    props.core_props.texture_features[0] = gpu.texture_features;
+    props.core_props.gpu_available_memory_size = default_available_memory;
+
+    props.l2_props.log2_line_size = l2_features & 0xFF;
+    props.l2_props.log2_cache_size = (l2_features >> 16) & 0xFF;
+    props.l2_props.num_l2_slices = gpu.num_l2_slices;
+
+    props.tiler_props.bin_size_bytes = get_prop_value(gpu, 16);
+    props.tiler_props.max_active_levels = get_prop_value(gpu, 17);
+
+    props.thread_props.max_threads = default_max_threads;
+    props.thread_props.max_workgroup_size = default_max_workgroup;
+    props.thread_props.max_barrier_size = default_max_barrier;
+    props.thread_props.max_registers = default_max_registers;
+    props.thread_props.max_task_queue = get_prop_value(gpu, 22);
+    props.thread_props.max_thread_group_split = get_prop_value(gpu, 23);
+    props.thread_props.impl_tech = get_prop_value(gpu, 24);
+
+    props.raw_props.shader_present = gpu.shader_present;
+    props.raw_props.tiler_present = get_prop_value(gpu, 26);
+    props.raw_props.l2_present = get_prop_value(gpu, 27);
+    props.raw_props.l2_features = l2_features;
+    props.raw_props.mem_features = 0;
+    props.raw_props.mmu_features = default_mmu_features;
+    props.raw_props.as_present = default_as_present;
+    props.raw_props.js_present = default_js_present;
+    std::copy(std::begin(default_js_features), std::end(default_js_features), props.raw_props.js_features);
+    props.raw_props.tiler_features = default_tiler_features;
+    props.raw_props.texture_features[0] = gpu.texture_features;
+    props.raw_props.gpu_id = static_cast<uint32_t>(gpu.raw_gpu_id);
+    props.raw_props.thread_max_threads = default_max_threads;
+    props.raw_props.thread_max_workgroup_size = default_max_workgroup;
+    props.raw_props.thread_max_barrier_size = default_max_barrier;
+    props.raw_props.thread_features = gpu.thread_features;
+    props.raw_props.coherency_mode = gpu.coherency_mode;
+
+    props.coherency_info.num_groups = gpu.num_core_groups;
+    props.coherency_info.num_core_groups = gpu.num_core_groups;
+    props.coherency_info.coherency = gpu.coherency_features;
+    for (uint32_t i = 0; i < kbase_pre_r21::base_max_coherent_groups; i++) {
+        auto& group = props.coherency_info.group[i];
+        group.core_mask = get_group_mask(gpu, i);
+        group.num_cores = __builtin_popcountll(group.core_mask);
+    }
+
+    return result;
+}
+
+/* See header for documentation */
+std::vector<unsigned char> encode_capture(
+    const fake_gpu& gpu
+) {
+    std::vector<unsigned char> payload;
+    detail::capture_kernel kernel { detail::capture_kernel::pre_r21 };
+
+    // Captures use the Arm ABI layout, which matches the host layout on all
+    // hosts that the development tools support
+    static_assert(sizeof(kbase_pre_r21::uk_gpuprops_t) == detail::pre_r21_props_size,
+                  "Host pre-r21 structure layout does not match the Arm ABI layout");
+
+    switch (gpu.kernel) {
+    case kernel_type::pre_r21: {
+        const auto props = encode_pre_r21_props(gpu);
+        const auto* bytes = reinterpret_cast<const unsigned char*>(&props);
+        payload.assign(bytes, bytes + sizeof(props));
+        break;
+    }
+    case kernel_type::post_r21_jm:
+        kernel = detail::capture_kernel::post_r21_jm;
+        payload = encode_post_r21_props(gpu);
+        break;
+    case kernel_type::post_r21_csf:
+        kernel = detail::capture_kernel::post_r21_csf;
+        payload = encode_post_r21_props(gpu);
+        break;
+    }
+
+    std::vector<unsigned char> capture(detail::capture_header_size + payload.size());
+    detail::write_capture_header(kernel, static_cast<uint32_t>(payload.size()), capture.data());
+    std::copy(payload.begin(), payload.end(), capture.begin() + detail::capture_header_size);
+    return capture;
+}
+
+/* See header for documentation */
+void install_device(
+    const fake_gpu& gpu,
+    uint32_t id
+) {
+    fake_device device { gpu, {}, {} };
+    if (gpu.kernel != kernel_type::pre_r21) {
+        device.post_r21_props = encode_post_r21_props(gpu);
+    }
+
+    get_devices()[id] = device;
+}
+
+/* See header for documentation */
+void remove_devices()
+{
+    get_devices().clear();
+}
+
+/* See header for documentation */
+const driver_interface& get_driver()
+{
+    return fake_driver;
+}
+
+}
+}
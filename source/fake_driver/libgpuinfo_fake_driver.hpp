@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief A fake Mali kernel driver for use in development tools.
+ *
+ * The fake driver implements the kernel driver system call interface in user
+ * space, responding to the same ioctl requests as a real kbase driver, so that
+ * the complete query path can be exercised on a host machine without a GPU.
+ *
+ * Devices are described by a @c fake_gpu structure, and installed as
+ * /dev/mali<id> nodes that are visible only via @c get_driver(). The fake
+ * driver state is global, and is not thread-safe.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "libgpuinfo.hpp"
+#include "libgpuinfo_kbase.hpp"
+
+namespace libarmgpuinfo {
+namespace fake {
+
+/** The kernel driver interface emulated by a fake device. */
+enum class kernel_type {
+    /** Pre-r21 JM kernel. */
+    pre_r21,
+    /** Post-r21 JM kernel. */
+    post_r21_jm,
+    /** Post-r21 CSF kernel. */
+    post_r21_csf
+};
+
+/**
+ * Test if the library backend for a kernel driver interface is included in
+ * the build. Queries of fake devices that use an excluded interface fail.
+ *
+ * @param kernel   The kernel driver interface.
+ *
+ * @return @c true if the backend is included.
+ */
+bool is_kernel_enabled(
+    kernel_type kernel);
+
+/** Description of a fake GPU and the kernel driver that reports it. */
+struct fake_gpu {
+    /** The kernel driver interface. */
+    kernel_type kernel { kernel_type::post_r21_jm };
+
+    /** The kernel driver interface major version. */
+    uint16_t version_major { 11 };
+
+    /** The kernel driver interface minor version. */
+    uint16_t version_minor { 40 };
+
+    /** The raw GPU_ID register value. */
+    uint64_t raw_gpu_id { 0 };
+
+    /** The SHADER_PRESENT register value. */
+    uint64_t shader_present { 0 };
+
+    /** The CORE_FEATURES register value. */
+    uint32_t core_features { 0 };
+
+    /** The THREAD_FEATURES register value. */
+    uint32_t thread_features { 0 };
+
+    /** The TEXTURE_FEATURES_0 register value. */
+    uint32_t texture_features { 0 };
+
+    /** The L2_FEATURES register value. */
+    uint32_t l2_features { 0 };
+
+    /** The number of L2 cache slices. */
+    uint32_t num_l2_slices { 1 };
+
+    /**
+     * The number of core groups, each with its own L2 cache. The shader cores
+     * are divided between the groups in index order.
+     */
+    uint32_t num_core_groups { 1 };
+
+    /** The selected COHERENCY_ENABLE value, where 31 is no coherency. */
+    uint32_t coherency_mode { 31 };
+
+    /** The COHERENCY_FEATURES register value. */
+    uint32_t coherency_features { 0x3 };
+
+    /** The number of CSF queue groups, ignored by JM kernels. */
+    uint32_t num_csf_groups { 8 };
+
+    /** The number of queues in each CSF queue group, ignored by JM kernels. */
+    uint32_t num_csf_queues { 8 };
+
+    /**
+     * The number of additional unknown properties appended to the property
+     * buffer, emulating a newer kernel driver. Ignored by pre-r21 kernels.
+     */
+    uint32_t num_unknown_props { 0 };
+
+    /**
+     * The property order seed. Zero reports the properties in kbase order,
+     * with any unknown properties last, and other values shuffle the known
+     * and unknown properties together. Ignored by pre-r21 kernels.
+     */
+    uint32_t prop_order_seed { 0 };
+
+    /** The kernel memory used by each kbase context, in bytes. */
+    uint64_t context_bytes { 256 * 1024 };
+};
+
+/**
+ * Make a fake GPU description with typical register values.
+ *
+ * @param kernel            The kernel driver interface.
+ * @param product_id        The GPU product ID, e.g. 0xa002 for Mali-G710.
+ * @param num_cores         The number of shader cores.
+ * @param core_features     The CORE_FEATURES register value.
+ * @param thread_features   The THREAD_FEATURES register value.
+ *
+ * @return The fake GPU description.
+ */
+fake_gpu make_gpu(
+    kernel_type kernel,
+    uint32_t product_id,
+    uint32_t num_cores,
+    uint32_t core_features=0,
+    uint32_t thread_features=0);
+
+/**
+ * Get the core mask of a fake GPU core group.
+ *
+ * @param gpu     The fake GPU description.
+ * @param group   The core group index.
+ *
+ * @return The core mask, or zero if the group does not exist.
+ */
+uint64_t get_group_mask(
+    const fake_gpu& gpu,
+    uint32_t group);
+
+/**
+ * Encode the post-r21 property buffer that a kernel driver would return.
+ *
+ * @param gpu   The fake GPU description.
+ *
+ * @return The encoded property buffer.
+ */
+std::vector<unsigned char> encode_post_r21_props(
+    const fake_gpu& gpu);
+
+/**
+ * Encode the pre-r21 property structure that a kernel driver would return.
+ *
+ * @param gpu   The fake GPU description.
+ *
+ * @return The encoded property structure.
+ */
+kbase_pre_r21::uk_gpuprops_t encode_pre_r21_props(
+    const fake_gpu& gpu);
+
+/**
+ * Encode a property capture of the data that a kernel driver would return.
+ *
+ * @param gpu   The fake GPU description.
+ *
+ * @return The encoded capture, in the format described in libgpuinfo_capture.hpp.
+ */
+std::vector<unsigned char> encode_capture(
+    const fake_gpu& gpu);
+
+/**
+ * Install a fake device, replacing any existing device with the same ID.
+ *
+ * @param gpu   The fake GPU description.
+ * @param id    The driver instance, e.g. 0 for /dev/mali0.
+ */
+void install_device(
+    const fake_gpu& gpu,
+    uint32_t id=0);
+
+/** Remove all installed fake devices. */
+void remove_devices();
+
+/** @return The system call interface for the fake kernel driver. */
+const driver_interface& get_driver();
+
+}
+}
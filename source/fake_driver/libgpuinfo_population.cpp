@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "fake_driver/libgpuinfo_population.hpp"
+#include "libgpuinfo_capture.hpp"
+#include "libgpuinfo_products.hpp"
+
+namespace libarmgpuinfo {
+namespace fake {
+
+namespace {
+
+/** The maximum number of shader cores that a fake GPU can report. */
+constexpr uint32_t max_fake_cores { 64 };
+
+/** Number of CORE_FEATURES values that variant decoders distinguish. */
+constexpr uint32_t num_core_variants { 8 };
+
+/** THREAD_FEATURES value of a single-engine configuration. */
+constexpr uint32_t single_engine_thread_features { 0x2000 };
+
+/** The kernel driver interfaces, indexed by kernel_type. */
+constexpr kernel_type kernels[num_kernel_types] {
+    kernel_type::pre_r21,
+    kernel_type::post_r21_jm,
+    kernel_type::post_r21_csf
+};
+
+/** A splitmix64 generator, so streams do not depend on the standard library. */
+class random_source {
+public:
+    explicit random_source(uint64_t seed)
+        : state_(seed) {}
+
+    /** @return The next 64-bit value. */
+    uint64_t next()
+    {
+        uint64_t value = (state_ += 0x9e3779b97f4a7c15ULL);
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+        return value ^ (value >> 31);
+    }
+
+    /** @return A uniform value in [0, 1). */
+    double uniform()
+    {
+        return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    /** @return A uniform value in [min, max). */
+    uint32_t range(uint32_t min, uint32_t max)
+    {
+        return min + static_cast<uint32_t>(((next() >> 32) * (max - min)) >> 32);
+    }
+
+    /**
+     * Sample an index from cumulative weights.
+     *
+     * @param cumulative   The cumulative weights, ending with the total weight.
+     *
+     * @return The sampled index.
+     */
+    std::size_t weighted(const std::vector<double>& cumulative)
+    {
+        const double point = uniform() * cumulative.back();
+        const auto it = std::upper_bound(cumulative.begin(), cumulative.end(), point);
+        return std::min<std::size_t>(it - cumulative.begin(), cumulative.size() - 1);
+    }
+
+private:
+    uint64_t state_;
+};
+
+/**
+ * Get the relative weight of each catalog entry.
+ *
+ * @param config   The population distributions.
+ *
+ * @return The cumulative weights, indexed by catalog entry.
+ */
+std::vector<double> get_entry_weights(
+    const population_config& config
+) {
+    std::vector<double> cumulative;
+    double total { 0.0 };
+    for (const auto& entry : detail::PRODUCT_VERSIONS) {
+        double weight = config.product_weights.empty() ? 1.0 : 0.0;
+        for (const auto& product : config.product_weights) {
+            if (product.first == entry.id) {
+                weight += product.second;
+            }
+        }
+
+        // Entries that share an ID share its weight
+        uint32_t num_entries { 0 };
+        for (const auto& other : detail::PRODUCT_VERSIONS) {
+            num_entries += (other.id == entry.id) ? 1 : 0;
+        }
+
+        total += std::max(weight, 0.0) / num_entries;
+        cumulative.push_back(total);
+    }
+
+    return cumulative;
+}
+
+/**
+ * Get the core count range of a catalog entry, which ends at the next entry
+ * with the same ID, or at the maximum core count.
+ *
+ * @param entry       The catalog entry.
+ * @param max_cores   The maximum core count.
+ * @param first       The returned first core count.
+ * @param last        The returned last core count, exclusive.
+ */
+void get_core_range(
+    const detail::product_entry& entry,
+    uint32_t max_cores,
+    uint32_t& first,
+    uint32_t& last
+) {
+    first = std::min(std::max(entry.min_cores, 1U), max_fake_cores);
+    last = std::min(max_cores, max_fake_cores) + 1;
+    for (const auto& other : detail::PRODUCT_VERSIONS) {
+        if ((other.id == entry.id) && (other.min_cores > entry.min_cores)) {
+            last = std::min(last, other.min_cores);
+        }
+    }
+
+    last = std::max(last, first + 1);
+}
+
+/**
+ * Sample a device configuration.
+ *
+ * @param config            The population distributions.
+ * @param entry_weights     The cumulative catalog entry weights.
+ * @param kernel_weights    The cumulative kernel driver interface weights.
+ * @param random            The random source.
+ *
+ * @return The configuration.
+ */
+fake_gpu sample_config(
+    const population_config& config,
+    const std::vector<double>& entry_weights,
+    const std::vector<double>& kernel_weights,
+    random_source& random
+) {
+    const auto& entry = detail::PRODUCT_VERSIONS[random.weighted(entry_weights)];
+    const kernel_type kernel = kernels[random.weighted(kernel_weights)];
+
+    uint32_t first_core { 0 };
+    uint32_t last_core { 0 };
+    get_core_range(entry, config.max_cores, first_core, last_core);
+    const uint32_t num_cores = random.range(first_core, last_core);
+
+    // Variant decoders read CORE_FEATURES or THREAD_FEATURES, and ignore the other
+    uint32_t core_features { 0 };
+    uint32_t thread_features { 0 };
+    if (detail::is_variant_entry(entry) && (random.uniform() < config.variant_fraction)) {
+        core_features = random.range(0, num_core_variants);
+        thread_features = (random.next() & 1) ? single_engine_thread_features : 0;
+    }
+
+    fake_gpu gpu = make_gpu(kernel, entry.id, num_cores, core_features, thread_features);
+    if (kernel != kernel_type::pre_r21) {
+        if (random.uniform() < config.unknown_fraction) {
+            gpu.num_unknown_props = random.range(1, std::max(config.max_unknown_props, 1U) + 1);
+        }
+
+        if (random.uniform() < config.shuffle_fraction) {
+            gpu.prop_order_seed = static_cast<uint32_t>(random.next() | 1);
+        }
+    }
+
+    return gpu;
+}
+
+}
+
+/* See header for documentation */
+population_generator::population_generator(const population_config& config)
+    : state_(0),
+      pending_(-1)
+{
+    random_source random(config.seed);
+    state_ = random.next() | 1;
+    const std::vector<double> entry_weights = get_entry_weights(config);
+
+    std::vector<double> kernel_weights;
+    double total_kernel_weight { 0.0 };
+    for (double weight : config.kernel_weights) {
+        total_kernel_weight += std::max(weight, 0.0);
+        kernel_weights.push_back(total_kernel_weight);
+    }
+
+    if ((entry_weights.back() <= 0.0) || (total_kernel_weight <= 0.0)) {
+        return;
+    }
+
+    // Configurations are sampled independently, so the pool follows the
+    // configured distributions exactly, and common configurations can occur
+    // more than once, as they would in a real fleet
+    for (uint32_t i = 0; i < config.num_configs; i++) {
+        fake_gpu gpu = sample_config(config, entry_weights, kernel_weights, random);
+        const std::vector<unsigned char> capture = encode_capture(gpu);
+        offsets_.push_back(captures_.size());
+        captures_.insert(captures_.end(), capture.begin(), capture.end());
+        configs_.push_back(gpu);
+    }
+
+    offsets_.push_back(captures_.size());
+
+    const std::size_t num_configs = configs_.size();
+    if (!num_configs) {
+        return;
+    }
+
+    double total_frequency { 0.0 };
+    for (std::size_t i = 0; i < num_configs; i++) {
+        frequencies_.push_back(1.0 / std::pow(static_cast<double>(i + 1), config.popularity_exponent));
+        total_frequency += frequencies_.back();
+    }
+
+    for (auto& frequency : frequencies_) {
+        frequency /= total_frequency;
+    }
+
+    // Build the alias tables using Vose's method, so sampling is constant time
+    std::vector<double> scaled;
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
+    for (std::size_t i = 0; i < num_configs; i++) {
+        scaled.push_back(frequencies_[i] * num_configs);
+        (scaled.back() < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+    }
+
+    thresholds_.assign(num_configs, UINT32_MAX);
+    aliases_.resize(num_configs);
+    for (std::size_t i = 0; i < num_configs; i++) {
+        aliases_[i] = static_cast<uint32_t>(i);
+    }
+
+    while (!small.empty() && !large.empty()) {
+        const uint32_t less = small.back();
+        const uint32_t more = large.back();
+        small.pop_back();
+        large.pop_back();
+
+        thresholds_[less] = static_cast<uint32_t>(std::min(scaled[less] * 4294967296.0, 4294967295.0));
+        aliases_[less] = more;
+        scaled[more] -= 1.0 - scaled[less];
+        (scaled[more] < 1.0 ? small : large).push_back(more);
+    }
+}
+
+/* See header for documentation */
+const std::vector<fake_gpu>& population_generator::get_configs() const
+{
+    return configs_;
+}
+
+/* See header for documentation */
+const std::vector<double>& population_generator::get_frequencies() const
+{
+    return frequencies_;
+}
+
+/* See header for documentation */
+const unsigned char* population_generator::get_capture(uint32_t index, std::size_t& size) const
+{
+    size = offsets_[index + 1] - offsets_[index];
+    return captures_.data() + offsets_[index];
+}
+
+/* See header for documentation */
+uint32_t population_generator::next_config()
+{
+    // A xorshift64* generator, which is cheaper than the pool sampling generator
+    state_ ^= state_ >> 12;
+    state_ ^= state_ << 25;
+    state_ ^= state_ >> 27;
+    const uint64_t value = state_ * 0x2545f4914f6cdd1dULL;
+
+    const uint32_t slot = static_cast<uint32_t>(((value >> 32) * thresholds_.size()) >> 32);
+    return (static_cast<uint32_t>(value) < thresholds_[slot]) ? slot : aliases_[slot];
+}
+
+/* See header for documentation */
+std::size_t population_generator::generate(
+    unsigned char* buffer,
+    std::size_t capacity,
+    uint64_t max_records,
+    uint64_t& num_records
+) {
+    num_records = 0;
+    if (configs_.empty()) {
+        return 0;
+    }
+
+    std::size_t written { 0 };
+    while (num_records < max_records) {
+        const uint32_t index = (pending_ >= 0) ? static_cast<uint32_t>(pending_) : next_config();
+        const std::size_t size = offsets_[index + 1] - offsets_[index];
+        if (size > (capacity - written)) {
+            pending_ = index;
+            break;
+        }
+
+        std::memcpy(buffer + written, captures_.data() + offsets_[index], size);
+        written += size;
+        num_records++;
+        pending_ = -1;
+    }
+
+    return written;
+}
+
+/* See header for documentation */
+bool next_stream_capture(
+    const unsigned char*& data,
+    std::size_t& size,
+    const unsigned char*& capture,
+    std::size_t& capture_size
+) {
+    if (size < detail::capture_header_size) {
+        return false;
+    }
+
+    const std::size_t payload_size = detail::load_le<uint32_t>(data + 8);
+    if (payload_size > (size - detail::capture_header_size)) {
+        return false;
+    }
+
+    capture = data;
+    capture_size = detail::capture_header_size + payload_size;
+    data += capture_size;
+    size -= capture_size;
+    return true;
+}
+
+}
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Synthetic device populations, for fleet-scale stress benchmarks.
+ *
+ * A population is a stream of device captures with the shape of real fleet
+ * data: a pool of device configurations, sampled from configurable
+ * distributions over the product catalog, core counts, product variants,
+ * kernel driver interfaces, and property buffer layouts, and a skewed
+ * popularity so that a few configurations account for most devices.
+ *
+ * The configuration pool is encoded once, and records are generated by
+ * sampling the pool and copying the encoded capture, so streams of millions
+ * of records can be generated at memory bandwidth. A stream is a sequence of
+ * captures in the format described in libgpuinfo_capture.hpp, with no other
+ * framing, so each capture header gives the size of the next record.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "fake_driver/libgpuinfo_fake_driver.hpp"
+
+namespace libarmgpuinfo {
+namespace fake {
+
+/** Number of kernel driver interface types. */
+constexpr uint32_t num_kernel_types { 3 };
+
+/** Distributions of a synthetic device population. */
+struct population_config {
+    /** The random seed. The same seed always generates the same stream. */
+    uint64_t seed { 1 };
+
+    /** The number of device configurations in the pool. */
+    uint32_t num_configs { 4096 };
+
+    /**
+     * The relative weight of each product ID. Catalog entries that share an
+     * ID share its weight. If empty, every catalog entry has equal weight.
+     */
+    std::vector<std::pair<uint32_t, double>> product_weights;
+
+    /** The maximum number of shader cores. */
+    uint32_t max_cores { 16 };
+
+    /** The relative weight of each kernel driver interface, indexed by kernel_type. */
+    double kernel_weights[num_kernel_types] { 1.0, 3.0, 2.0 };
+
+    /** The fraction of configurations of variant products that use a non-default variant. */
+    double variant_fraction { 0.5 };
+
+    /** The fraction of post-r21 configurations that report properties in a shuffled order. */
+    double shuffle_fraction { 0.1 };
+
+    /** The fraction of post-r21 configurations that report unknown properties. */
+    double unknown_fraction { 0.1 };
+
+    /** The maximum number of unknown properties reported by a configuration. */
+    uint32_t max_unknown_props { 64 };
+
+    /**
+     * The Zipf exponent of configuration popularity, where configuration k
+     * has relative frequency 1 / (k + 1)^exponent. Zero is uniform.
+     */
+    double popularity_exponent { 1.0 };
+};
+
+/** Generator of a synthetic device population stream. */
+class population_generator {
+public:
+    /**
+     * Create a generator, building and encoding the configuration pool.
+     *
+     * Configurations are sampled independently, so common configurations
+     * can occur more than once in the pool. The pool is empty if the
+     * product or kernel weights are all zero.
+     *
+     * @param config   The population distributions.
+     */
+    explicit population_generator(const population_config& config);
+
+    /** @return The configurations, most popular first. */
+    const std::vector<fake_gpu>& get_configs() const;
+
+    /** @return The relative frequency of each configuration. */
+    const std::vector<double>& get_frequencies() const;
+
+    /**
+     * Get the encoded capture of a configuration.
+     *
+     * @param index   The configuration index.
+     * @param size    The returned capture size in bytes.
+     *
+     * @return The capture data.
+     */
+    const unsigned char* get_capture(uint32_t index, std::size_t& size) const;
+
+    /** @return The configuration index of the next record, advancing the stream. */
+    uint32_t next_config();
+
+    /**
+     * Generate whole records into a buffer.
+     *
+     * The stream does not depend on the buffer sizes used to generate it.
+     *
+     * @param buffer        The output buffer.
+     * @param capacity      The output buffer size in bytes.
+     * @param max_records   The maximum number of records to generate.
+     * @param num_records   The returned number of records generated.
+     *
+     * @return The number of bytes written.
+     */
+    std::size_t generate(
+        unsigned char* buffer,
+        std::size_t capacity,
+        uint64_t max_records,
+        uint64_t& num_records);
+
+private:
+    /** The configurations, most popular first. */
+    std::vector<fake_gpu> configs_;
+
+    /** The relative frequency of each configuration. */
+    std::vector<double> frequencies_;
+
+    /** The encoded captures, concatenated, and the offset of each capture. */
+    std::vector<unsigned char> captures_;
+    std::vector<std::size_t> offsets_;
+
+    /** The alias method sampling tables. */
+    std::vector<uint32_t> thresholds_;
+    std::vector<uint32_t> aliases_;
+
+    /** The sampling generator state. */
+    uint64_t state_;
+
+    /** The configuration of a record that did not fit in the last buffer, or -1. */
+    int64_t pending_;
+};
+
+/**
+ * Split the next capture from a stream.
+ *
+ * @param data      The stream data, advanced past the capture.
+ * @param size      The remaining stream size in bytes, reduced by the capture size.
+ * @param capture   The returned capture data.
+ * @param capture_size   The returned capture size in bytes.
+ *
+ * @return @c true if a complete capture was split, @c false at the end of the
+ *         stream or if the stream is malformed.
+ */
+bool next_stream_capture(
+    const unsigned char*& data,
+    std::size_t& size,
+    const unsigned char*& capture,
+    std::size_t& capture_size);
+
+}
+}
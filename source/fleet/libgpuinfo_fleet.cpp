@@ -0,0 +1,868 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <new>
+#include <unordered_map>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "libgpuinfo_capture.hpp"
+#include "fleet/libgpuinfo_fleet.hpp"
+
+namespace libarmgpuinfo {
+namespace fleet {
+
+namespace {
+
+using detail::load_le;
+using detail::store_le;
+
+/** Store magic, the characters "MGPF" as a little-endian value. */
+constexpr uint32_t store_magic { 0x4650474d };
+
+/** Store format version. */
+constexpr uint16_t store_version { 1 };
+
+/** Sizes of the store header and table entries, in bytes. */
+constexpr std::size_t header_size { 48 };
+constexpr std::size_t column_entry_size { 72 };
+constexpr std::size_t chunk_entry_size { 32 };
+constexpr std::size_t column_name_size { 32 };
+
+/** A decoded capture, and the device information that is not in the capture. */
+struct row {
+    /** The shared decoded capture. */
+    const interned_capture& device;
+
+    /** The maximum GPU clock, in Hz. */
+    uint64_t max_clock_hz;
+};
+
+/** A decoded gpuinfo column. */
+struct field {
+    /** The column name. */
+    const char* name;
+
+    /** Get the value of an integer column. */
+    uint64_t (*get)(const row&);
+
+    /** Get the string of a dictionary column. */
+    const char* (*get_string)(const row&);
+};
+
+/** The decoded gpuinfo columns, which precede the raw property columns. */
+const field FIELDS[] {
+    { "kernel", [](const row& r) -> uint64_t { return static_cast<uint64_t>(r.device.kernel); }, nullptr },
+    { "max_clock_hz", [](const row& r) -> uint64_t { return r.max_clock_hz; }, nullptr },
+    { "name", nullptr, [](const row& r) { return r.device.info.gpu_name ? r.device.info.gpu_name : ""; } },
+    { "architecture", nullptr, [](const row& r) { return r.device.info.architecture_name ? r.device.info.architecture_name : ""; } },
+    { "gpu_id", [](const row& r) -> uint64_t { return r.device.info.gpu_id; }, nullptr },
+    { "architecture_major", [](const row& r) -> uint64_t { return r.device.info.architecture_major; }, nullptr },
+    { "architecture_minor", [](const row& r) -> uint64_t { return r.device.info.architecture_minor; }, nullptr },
+    { "num_shader_cores", [](const row& r) -> uint64_t { return r.device.info.num_shader_cores; }, nullptr },
+    { "shader_core_mask", [](const row& r) -> uint64_t { return r.device.info.shader_core_mask; }, nullptr },
+    { "num_core_groups", [](const row& r) -> uint64_t { return r.device.info.topology.num_groups; }, nullptr },
+    { "num_l2_slices", [](const row& r) -> uint64_t { return r.device.info.num_l2_slices; }, nullptr },
+    { "num_l2_bytes", [](const row& r) -> uint64_t { return r.device.info.num_l2_bytes; }, nullptr },
+    { "num_l2_line_bytes", [](const row& r) -> uint64_t { return r.device.info.num_l2_line_bytes; }, nullptr },
+    { "num_bus_bits", [](const row& r) -> uint64_t { return r.device.info.num_bus_bits; }, nullptr },
+    { "num_exec_engines", [](const row& r) -> uint64_t { return r.device.info.num_exec_engines; }, nullptr },
+    { "num_fp32_fmas_per_cy", [](const row& r) -> uint64_t { return r.device.info.num_fp32_fmas_per_cy; }, nullptr },
+    { "num_fp16_fmas_per_cy", [](const row& r) -> uint64_t { return r.device.info.num_fp16_fmas_per_cy; }, nullptr },
+    { "num_int8_macs_per_cy", [](const row& r) -> uint64_t { return r.device.info.num_int8_macs_per_cy; }, nullptr },
+    { "num_fp16_macs_per_cy", [](const row& r) -> uint64_t { return r.device.info.num_fp16_macs_per_cy; }, nullptr },
+    { "num_texels_per_cy", [](const row& r) -> uint64_t { return r.device.info.num_texels_per_cy; }, nullptr },
+    { "num_pixels_per_cy", [](const row& r) -> uint64_t { return r.device.info.num_pixels_per_cy; }, nullptr },
+    { "texture_formats", [](const row& r) -> uint64_t { return r.device.info.texture_formats; }, nullptr },
+    { "coherency", [](const row& r) -> uint64_t { return static_cast<uint64_t>(r.device.info.coherency); }, nullptr },
+    { "num_gpu_memory_bytes", [](const row& r) -> uint64_t { return r.device.info.num_gpu_memory_bytes; }, nullptr },
+    { "num_va_bits", [](const row& r) -> uint64_t { return r.device.info.num_va_bits; }, nullptr },
+    { "scheduler", [](const row& r) -> uint64_t { return static_cast<uint64_t>(r.device.info.queues.scheduler); }, nullptr },
+    { "num_job_slots", [](const row& r) -> uint64_t { return r.device.info.queues.num_job_slots; }, nullptr },
+    { "num_tiler_prims_per_cy", [](const row& r) -> uint64_t { return r.device.info.tiler.num_prims_per_cy; }, nullptr },
+    { "num_threads_per_core", [](const row& r) -> uint64_t { return r.device.info.num_threads_per_core; }, nullptr },
+    { "num_registers_per_core", [](const row& r) -> uint64_t { return r.device.info.num_registers_per_core; }, nullptr },
+};
+
+constexpr uint32_t num_fields { sizeof(FIELDS) / sizeof(FIELDS[0]) };
+
+/** Total number of columns, with a raw property column for codes 1 to max_prop_code. */
+constexpr uint32_t num_columns { num_fields + max_prop_code };
+
+/** @return The name of a column. */
+std::string get_column_name(uint32_t column)
+{
+    if (column < num_fields) {
+        return FIELDS[column].name;
+    }
+
+    return "prop_" + std::to_string(column - num_fields + 1);
+}
+
+/** @return The number of bits needed to store a value. */
+uint32_t get_bits(uint64_t value)
+{
+    return value ? static_cast<uint32_t>(64 - __builtin_clzll(value)) : 0;
+}
+
+/** @return The size of a chunk of packed values, in bytes, including the padding word. */
+uint64_t get_chunk_bytes(uint32_t count, uint32_t bits)
+{
+    return (((uint64_t { count } * bits + 63) / 64) + 1) * sizeof(uint64_t);
+}
+
+/**
+ * Unpack a chunk of frame-of-reference bit-packed values.
+ *
+ * @param data     The chunk data, including the padding word.
+ * @param count    The number of values.
+ * @param bits     The bits per value.
+ * @param min      The chunk minimum.
+ * @param values   The returned values.
+ */
+void unpack(
+    const unsigned char* data,
+    uint32_t count,
+    uint32_t bits,
+    uint64_t min,
+    uint64_t* values
+) {
+    if (!bits) {
+        std::fill(values, values + count, min);
+        return;
+    }
+
+    const uint64_t mask = (bits == 64) ? ~0ULL : ((1ULL << bits) - 1);
+    uint64_t pos { 0 };
+    for (uint32_t i = 0; i < count; i++, pos += bits) {
+        const unsigned char* word = data + (pos / 64) * sizeof(uint64_t);
+        const uint32_t shift = pos % 64;
+        uint64_t value = load_le<uint64_t>(word) >> shift;
+        if (shift) {
+            value |= load_le<uint64_t>(word + sizeof(uint64_t)) << (64 - shift);
+        }
+
+        values[i] = min + (value & mask);
+    }
+}
+
+/** Metadata of a chunk. */
+struct chunk {
+    uint64_t offset;
+    uint64_t min;
+    uint64_t max;
+    uint32_t bits;
+};
+
+}
+
+/** Writer state. */
+struct writer::impl {
+    explicit impl(std::size_t cache_entries)
+        : cache(cache_entries) {}
+
+    /** The decoded captures, shared by rows with the same capture data. */
+    capture_cache cache;
+
+    /** The output file. */
+    FILE* file { nullptr };
+
+    /** The write offset. */
+    uint64_t offset { 0 };
+
+    /** The number of rows added. */
+    uint64_t num_rows { 0 };
+
+    /** The buffered values of the current block, for each column. */
+    std::vector<std::vector<uint64_t>> values;
+
+    /** The metadata of each written chunk, in block-major order. */
+    std::vector<chunk> chunks;
+
+    /** The dictionary of each column, and the index of each string. */
+    std::vector<std::vector<std::string>> dictionaries;
+    std::vector<std::unordered_map<std::string, uint64_t>> dictionary_indices;
+
+    /** The minimum and maximum of each column over all rows. */
+    std::vector<uint64_t> mins;
+    std::vector<uint64_t> maxs;
+
+    /** Set if any write failed. */
+    bool failed { false };
+
+    /** Write data at the current offset. */
+    void write(const void* data, std::size_t size) {
+        if (size && (fwrite(data, 1, size, file) != size)) {
+            failed = true;
+        }
+
+        offset += size;
+    }
+
+    /** Encode and write the buffered block. */
+    void flush_block() {
+        const auto count = static_cast<uint32_t>(values[0].size());
+        if (!count) {
+            return;
+        }
+
+        std::vector<unsigned char> data;
+        for (uint32_t c = 0; c < num_columns; c++) {
+            const auto& column = values[c];
+            const auto range = std::minmax_element(column.begin(), column.end());
+            const uint64_t min = *range.first;
+            const uint64_t max = *range.second;
+            const uint32_t bits = get_bits(max - min);
+
+            data.assign(get_chunk_bytes(count, bits), 0);
+            uint64_t pos { 0 };
+            for (uint32_t i = 0; (i < count) && bits; i++, pos += bits) {
+                const uint64_t value = column[i] - min;
+                unsigned char* word = data.data() + (pos / 64) * sizeof(uint64_t);
+                const uint32_t shift = pos % 64;
+                store_le<uint64_t>(word, load_le<uint64_t>(word) | (value << shift));
+                if (shift && ((shift + bits) > 64)) {
+                    store_le<uint64_t>(word + sizeof(uint64_t), value >> (64 - shift));
+                }
+            }
+
+            chunks.push_back({ offset, min, max, bits });
+            write(data.data(), data.size());
+
+            mins[c] = (num_rows == count) ? min : std::min(mins[c], min);
+            maxs[c] = (num_rows == count) ? max : std::max(maxs[c], max);
+        }
+
+        for (auto& column : values) {
+            column.clear();
+        }
+    }
+};
+
+/* See header for documentation */
+std::unique_ptr<writer> writer::create(const std::string& path, std::size_t cache_entries)
+{
+    std::unique_ptr<impl> state { new (std::nothrow) impl(cache_entries) };
+    if (!state) {
+        return nullptr;
+    }
+
+    state->file = fopen(path.c_str(), "wb");
+    if (!state->file) {
+        return nullptr;
+    }
+
+    // The header is rewritten when the store is finished
+    const unsigned char header[header_size] {};
+    state->write(header, sizeof(header));
+
+    state->values.resize(num_columns);
+    for (auto& column : state->values) {
+        column.reserve(block_rows);
+    }
+
+    state->dictionaries.resize(num_columns);
+    state->dictionary_indices.resize(num_columns);
+    state->mins.resize(num_columns);
+    state->maxs.resize(num_columns);
+
+    return std::unique_ptr<writer>(new (std::nothrow) writer(std::move(state)));
+}
+
+/* See header for documentation */
+bool writer::add(const void* capture, std::size_t size, uint64_t max_clock_hz)
+{
+    const auto shared = impl_->cache.intern(capture, size);
+    if (!shared) {
+        return false;
+    }
+
+    const row device { *shared, max_clock_hz };
+    for (uint32_t c = 0; c < num_fields; c++) {
+        const field& f = FIELDS[c];
+        if (f.get) {
+            impl_->values[c].push_back(f.get(device));
+            continue;
+        }
+
+        // Dictionary columns store the index of the string
+        const std::string value { f.get_string(device) };
+        auto& indices = impl_->dictionary_indices[c];
+        auto it = indices.find(value);
+        if (it == indices.end()) {
+            it = indices.emplace(value, impl_->dictionaries[c].size()).first;
+            impl_->dictionaries[c].push_back(value);
+        }
+
+        impl_->values[c].push_back(it->second);
+    }
+
+    for (uint32_t code = 1; code <= max_prop_code; code++) {
+        impl_->values[num_fields + code - 1].push_back(shared->raw_props[code]);
+    }
+
+    impl_->num_rows++;
+    if (impl_->values[0].size() == block_rows) {
+        impl_->flush_block();
+    }
+
+    return true;
+}
+
+/* See header for documentation */
+bool writer::finish()
+{
+    if (!impl_->file) {
+        return false;
+    }
+
+    impl_->flush_block();
+
+    // Dictionaries
+    std::vector<uint64_t> dict_offsets(num_columns);
+    std::vector<uint64_t> dict_sizes(num_columns);
+    for (uint32_t c = 0; c < num_columns; c++) {
+        dict_offsets[c] = impl_->offset;
+        for (const auto& value : impl_->dictionaries[c]) {
+            impl_->write(value.c_str(), value.size() + 1);
+        }
+
+        dict_sizes[c] = impl_->offset - dict_offsets[c];
+    }
+
+    // Column table
+    const uint64_t column_table_offset = impl_->offset;
+    for (uint32_t c = 0; c < num_columns; c++) {
+        unsigned char entry[column_entry_size] {};
+        const std::string name = get_column_name(c);
+        std::memcpy(entry, name.c_str(), std::min(name.size(), column_name_size - 1));
+
+        const bool is_dictionary = (c < num_fields) && !FIELDS[c].get;
+        const auto type = is_dictionary ? column_type::dictionary : column_type::integer;
+        store_le<uint32_t>(entry + 32, static_cast<uint32_t>(type));
+        store_le<uint32_t>(entry + 36, static_cast<uint32_t>(impl_->dictionaries[c].size()));
+        store_le<uint64_t>(entry + 40, impl_->mins[c]);
+        store_le<uint64_t>(entry + 48, impl_->maxs[c]);
+        store_le<uint64_t>(entry + 56, dict_offsets[c]);
+        store_le<uint64_t>(entry + 64, dict_sizes[c]);
+        impl_->write(entry, sizeof(entry));
+    }
+
+    // Chunk table
+    const uint64_t chunk_table_offset = impl_->offset;
+    for (const auto& metadata : impl_->chunks) {
+        unsigned char entry[chunk_entry_size] {};
+        store_le<uint64_t>(entry, metadata.offset);
+        store_le<uint64_t>(entry + 8, metadata.min);
+        store_le<uint64_t>(entry + 16, metadata.max);
+        store_le<uint32_t>(entry + 24, metadata.bits);
+        impl_->write(entry, sizeof(entry));
+    }
+
+    unsigned char header[header_size] {};
+    store_le<uint32_t>(header, store_magic);
+    store_le<uint16_t>(header + 4, store_version);
+    store_le<uint16_t>(header + 6, static_cast<uint16_t>(num_columns));
+    store_le<uint32_t>(header + 8, block_rows);
+    store_le<uint32_t>(header + 12, static_cast<uint32_t>(impl_->chunks.size() / num_columns));
+    store_le<uint64_t>(header + 16, impl_->num_rows);
+    store_le<uint64_t>(header + 24, column_table_offset);
+    store_le<uint64_t>(header + 32, chunk_table_offset);
+
+    if ((fseek(impl_->file, 0, SEEK_SET) != 0) ||
+        (fwrite(header, 1, sizeof(header), impl_->file) != sizeof(header))) {
+        impl_->failed = true;
+    }
+
+    const bool closed = fclose(impl_->file) == 0;
+    impl_->file = nullptr;
+    return closed && !impl_->failed;
+}
+
+/* See header for documentation */
+uint64_t writer::num_rows() const
+{
+    return impl_->num_rows;
+}
+
+/* See header for documentation */
+capture_cache_stats writer::get_cache_stats() const
+{
+    return impl_->cache.get_stats();
+}
+
+/* See header for documentation */
+writer::~writer()
+{
+    if (impl_->file) {
+        fclose(impl_->file);
+    }
+}
+
+/* See header for documentation */
+writer::writer(std::unique_ptr<impl> state)
+    : impl_(std::move(state)) {}
+
+/** Store state. */
+struct store::impl {
+    /** The mapped file. */
+    const unsigned char* data { nullptr };
+
+    /** The mapped file size. */
+    std::size_t size { 0 };
+
+    /** The number of rows. */
+    uint64_t num_rows { 0 };
+
+    /** The number of blocks. */
+    uint32_t num_blocks { 0 };
+
+    /** The column descriptions. */
+    std::vector<column_info> columns;
+
+    /** The chunk metadata, in block-major order. */
+    std::vector<chunk> chunks;
+
+    /** Parse and validate the store metadata. */
+    bool parse() {
+        if ((size < header_size) ||
+            (load_le<uint32_t>(data) != store_magic) ||
+            (load_le<uint16_t>(data + 4) != store_version) ||
+            (load_le<uint32_t>(data + 8) != block_rows)) {
+            return false;
+        }
+
+        const uint32_t column_count = load_le<uint16_t>(data + 6);
+        num_blocks = load_le<uint32_t>(data + 12);
+        num_rows = load_le<uint64_t>(data + 16);
+        const uint64_t column_table_offset = load_le<uint64_t>(data + 24);
+        const uint64_t chunk_table_offset = load_le<uint64_t>(data + 32);
+
+        // Every block except the last is full
+        const uint64_t expected_blocks = (num_rows + block_rows - 1) / block_rows;
+        if (!column_count || (num_blocks != expected_blocks)) {
+            return false;
+        }
+
+        if (!in_bounds(column_table_offset, uint64_t { column_count } * column_entry_size) ||
+            !in_bounds(chunk_table_offset, uint64_t { column_count } * num_blocks * chunk_entry_size)) {
+            return false;
+        }
+
+        columns.resize(column_count);
+        for (uint32_t c = 0; c < column_count; c++) {
+            const unsigned char* entry = data + column_table_offset + c * column_entry_size;
+            if (!parse_column(entry, columns[c])) {
+                return false;
+            }
+        }
+
+        chunks.resize(uint64_t { column_count } * num_blocks);
+        for (uint32_t b = 0; b < num_blocks; b++) {
+            const uint32_t count = get_block_rows(b);
+            for (uint32_t c = 0; c < column_count; c++) {
+                const std::size_t index = std::size_t { b } * column_count + c;
+                const unsigned char* entry = data + chunk_table_offset + index * chunk_entry_size;
+
+                chunk& metadata = chunks[index];
+                metadata.offset = load_le<uint64_t>(entry);
+                metadata.min = load_le<uint64_t>(entry + 8);
+                metadata.max = load_le<uint64_t>(entry + 16);
+                metadata.bits = load_le<uint32_t>(entry + 24);
+                if ((metadata.min > metadata.max) || (metadata.bits > get_bits(metadata.max - metadata.min)) ||
+                    !in_bounds(metadata.offset, get_chunk_bytes(count, metadata.bits))) {
+                    return false;
+                }
+
+                // Chunk ranges must be within the column range, which bounds
+                // the group keys and dictionary indices of queries
+                if ((metadata.min < columns[c].min) || (metadata.max > columns[c].max)) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /** Parse and validate a column table entry. */
+    bool parse_column(const unsigned char* entry, column_info& column) {
+        const char* name = reinterpret_cast<const char*>(entry);
+        column.name.assign(name, strnlen(name, column_name_size));
+        column.type = static_cast<column_type>(load_le<uint32_t>(entry + 32));
+        const uint32_t num_entries = load_le<uint32_t>(entry + 36);
+        column.min = load_le<uint64_t>(entry + 40);
+        column.max = load_le<uint64_t>(entry + 48);
+        const uint64_t dict_offset = load_le<uint64_t>(entry + 56);
+        const uint64_t dict_size = load_le<uint64_t>(entry + 64);
+
+        if ((column.type != column_type::integer) && (column.type != column_type::dictionary)) {
+            return false;
+        }
+
+        if (!in_bounds(dict_offset, dict_size) || (num_entries > dict_size)) {
+            return false;
+        }
+
+        const char* dict = reinterpret_cast<const char*>(data + dict_offset);
+        std::size_t pos { 0 };
+        for (uint32_t i = 0; i < num_entries; i++) {
+            const std::size_t length = strnlen(dict + pos, dict_size - pos);
+            if (pos + length >= dict_size) {
+                return false;
+            }
+
+            column.dictionary.emplace_back(dict + pos, length);
+            pos += length + 1;
+        }
+
+        // Dictionary indices must be in range for every row
+        if ((column.type == column_type::dictionary) && num_rows && (column.max >= num_entries)) {
+            return false;
+        }
+
+        return true;
+    }
+
+    /** @return @c true if a range is within the file. */
+    bool in_bounds(uint64_t offset, uint64_t length) const {
+        return (offset <= size) && (length <= (size - offset));
+    }
+
+    /** @return The number of rows in a block. */
+    uint32_t get_block_rows(uint32_t block) const {
+        const uint64_t first = uint64_t { block } * block_rows;
+        return static_cast<uint32_t>(std::min<uint64_t>(block_rows, num_rows - first));
+    }
+};
+
+/* See header for documentation */
+std::unique_ptr<store> store::open(const std::string& path)
+{
+    std::unique_ptr<impl> state { new (std::nothrow) impl() };
+    if (!state) {
+        return nullptr;
+    }
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat s {};
+    if ((fstat(fd, &s) < 0) || (s.st_size <= 0)) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    // The mapping remains valid after the file is closed
+    void* mapping = mmap(nullptr, static_cast<std::size_t>(s.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+
+    state->data = static_cast<const unsigned char*>(mapping);
+    state->size = static_cast<std::size_t>(s.st_size);
+
+    // The store unmaps the file on destruction, including on failure
+    std::unique_ptr<store> result { new (std::nothrow) store(std::move(state)) };
+    if (!result) {
+        munmap(mapping, static_cast<std::size_t>(s.st_size));
+        return nullptr;
+    }
+
+    if (!result->impl_->parse()) {
+        return nullptr;
+    }
+
+    return result;
+}
+
+/* See header for documentation */
+uint64_t store::num_rows() const
+{
+    return impl_->num_rows;
+}
+
+/* See header for documentation */
+uint32_t store::num_blocks() const
+{
+    return impl_->num_blocks;
+}
+
+/* See header for documentation */
+uint32_t store::get_block_rows(uint32_t block) const
+{
+    return impl_->get_block_rows(block);
+}
+
+/* See header for documentation */
+const std::vector<column_info>& store::get_columns() const
+{
+    return impl_->columns;
+}
+
+/* See header for documentation */
+int store::find_column(const std::string& name) const
+{
+    for (std::size_t c = 0; c < impl_->columns.size(); c++) {
+        if (impl_->columns[c].name == name) {
+            return static_cast<int>(c);
+        }
+    }
+
+    return -1;
+}
+
+/* See header for documentation */
+void store::get_chunk_range(uint32_t column, uint32_t block, uint64_t& min, uint64_t& max, uint32_t& bits) const
+{
+    const chunk& metadata = impl_->chunks[std::size_t { block } * impl_->columns.size() + column];
+    min = metadata.min;
+    max = metadata.max;
+    bits = metadata.bits;
+}
+
+/* See header for documentation */
+uint32_t store::read_chunk(uint32_t column, uint32_t block, uint64_t* values) const
+{
+    const chunk& metadata = impl_->chunks[std::size_t { block } * impl_->columns.size() + column];
+    const uint32_t count = impl_->get_block_rows(block);
+    unpack(impl_->data + metadata.offset, count, metadata.bits, metadata.min, values);
+    return count;
+}
+
+/* See header for documentation */
+store::~store()
+{
+    if (impl_->data) {
+        munmap(const_cast<unsigned char*>(impl_->data), impl_->size);
+    }
+}
+
+/* See header for documentation */
+store::store(std::unique_ptr<impl> state)
+    : impl_(std::move(state)) {}
+
+namespace {
+
+/** Derived metrics, computed from several columns. */
+struct derived_metric {
+    /** The metric name. */
+    const char* name;
+
+    /** The per-core rate column. */
+    const char* rate_column;
+};
+
+constexpr derived_metric DERIVED_METRICS[] {
+    { "fp32_gflops", "num_fp32_fmas_per_cy" },
+    { "fp16_gflops", "num_fp16_fmas_per_cy" },
+    { "int8_gops", "num_int8_macs_per_cy" }
+};
+
+/** Aggregation state of a group. */
+struct group_state {
+    uint64_t count { 0 };
+    uint64_t min { ~0ULL };
+    uint64_t max { 0 };
+    uint64_t sum { 0 };
+    std::vector<uint64_t> buckets;
+};
+
+/** Maximum key range of groups that are accumulated in a dense array. */
+constexpr uint64_t max_dense_groups { 65536 };
+
+/** A resolved filter. */
+struct column_filter {
+    uint32_t column;
+    uint64_t min;
+    uint64_t max;
+};
+
+}
+
+/* See header for documentation */
+bool run_query(
+    const store& db,
+    const query& request,
+    query_result& result
+) {
+    result = query_result {};
+
+    const int group_column = db.find_column(request.group_by);
+    if (group_column < 0) {
+        return false;
+    }
+
+    // The metric is either a column, or a rate scaled by cores and clock
+    int metric_column = db.find_column(request.metric);
+    int cores_column { -1 };
+    int clock_column { -1 };
+    if (metric_column < 0) {
+        for (const auto& metric : DERIVED_METRICS) {
+            if (request.metric == metric.name) {
+                metric_column = db.find_column(metric.rate_column);
+                cores_column = db.find_column("num_shader_cores");
+                clock_column = db.find_column("max_clock_hz");
+            }
+        }
+
+        if ((metric_column < 0) || (cores_column < 0) || (clock_column < 0)) {
+            return false;
+        }
+    }
+
+    std::vector<column_filter> filters;
+    for (const auto& filter : request.filters) {
+        const int column = db.find_column(filter.column);
+        if (column < 0) {
+            return false;
+        }
+
+        filters.push_back({ static_cast<uint32_t>(column), filter.min, filter.max });
+    }
+
+    // Groups are dense when the key range is small, such as for dictionary columns
+    const auto& group_info = db.get_columns()[group_column];
+    const bool dense_groups = (group_info.max - group_info.min) < max_dense_groups;
+    std::vector<group_state> dense;
+    std::map<uint64_t, group_state> sparse;
+    if (dense_groups && db.num_rows()) {
+        dense.resize(group_info.max - group_info.min + 1);
+    }
+
+    std::vector<uint64_t> keys(block_rows);
+    std::vector<uint64_t> metrics(block_rows);
+    std::vector<uint64_t> scratch(block_rows);
+    std::vector<unsigned char> selected(block_rows);
+
+    for (uint32_t b = 0; b < db.num_blocks(); b++) {
+        // Skip blocks where no row can pass a filter
+        bool skip { false };
+        for (const auto& filter : filters) {
+            uint64_t min { 0 };
+            uint64_t max { 0 };
+            uint32_t bits { 0 };
+            db.get_chunk_range(filter.column, b, min, max, bits);
+            skip = skip || (max < filter.min) || (min > filter.max);
+        }
+
+        if (skip) {
+            result.num_blocks_skipped++;
+            continue;
+        }
+
+        result.num_blocks_scanned++;
+        const uint32_t count = db.get_block_rows(b);
+
+        std::fill(selected.begin(), selected.begin() + count, 1);
+        for (const auto& filter : filters) {
+            db.read_chunk(filter.column, b, scratch.data());
+            for (uint32_t i = 0; i < count; i++) {
+                selected[i] &= (scratch[i] >= filter.min) & (scratch[i] <= filter.max);
+            }
+        }
+
+        db.read_chunk(static_cast<uint32_t>(metric_column), b, metrics.data());
+        if (cores_column >= 0) {
+            // Two operations per FMA or MAC, reported in units of 10^9
+            db.read_chunk(static_cast<uint32_t>(cores_column), b, scratch.data());
+            for (uint32_t i = 0; i < count; i++) {
+                metrics[i] *= scratch[i] * 2;
+            }
+
+            db.read_chunk(static_cast<uint32_t>(clock_column), b, scratch.data());
+            for (uint32_t i = 0; i < count; i++) {
+                metrics[i] = (metrics[i] * (scratch[i] / 1000)) / 1000000;
+            }
+        }
+
+        db.read_chunk(static_cast<uint32_t>(group_column), b, keys.data());
+        for (uint32_t i = 0; i < count; i++) {
+            // Packed values can exceed the chunk maximum in a corrupt store,
+            // so rows with keys outside the column range are rejected
+            if (!selected[i] || (keys[i] < group_info.min) || (keys[i] > group_info.max)) {
+                continue;
+            }
+
+            group_state& group = dense_groups ? dense[keys[i] - group_info.min] : sparse[keys[i]];
+            const uint64_t value = metrics[i];
+            group.count++;
+            group.min = std::min(group.min, value);
+            group.max = std::max(group.max, value);
+            group.sum += value;
+
+            if (request.bucket_width) {
+                const uint64_t bucket = value / request.bucket_width;
+                if (bucket >= group.buckets.size()) {
+                    group.buckets.resize(bucket + 1);
+                }
+
+                group.buckets[bucket]++;
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < dense.size(); i++) {
+        if (dense[i].count) {
+            sparse[group_info.min + i] = std::move(dense[i]);
+        }
+    }
+
+    for (const auto& entry : sparse) {
+        group_result group {};
+        if (group_info.type == column_type::dictionary) {
+            group.key = group_info.dictionary[entry.first];
+        } else {
+            group.key = std::to_string(entry.first);
+        }
+
+        group.count = entry.second.count;
+        group.min = entry.second.min;
+        group.max = entry.second.max;
+        group.sum = entry.second.sum;
+        group.buckets = entry.second.buckets;
+        result.groups.push_back(std::move(group));
+    }
+
+    // Integer groups are already in value order
+    if (group_info.type == column_type::dictionary) {
+        std::sort(result.groups.begin(), result.groups.end(),
+                  [](const group_result& a, const group_result& b) { return a.key < b.key; });
+    }
+
+    return true;
+}
+
+}
+}
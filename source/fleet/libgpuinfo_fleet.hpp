@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief A columnar store for the decoded GPU configurations of a fleet.
+ *
+ * A fleet store holds one row per device capture, with a column for each
+ * decoded gpuinfo field, and a column for each raw post-r21 property code.
+ * Rows are split into blocks of block_rows rows, and each column of a block
+ * is stored as a chunk of frame-of-reference bit-packed values: the chunk
+ * minimum, and the difference of each value from it packed into the minimum
+ * number of bits. Columns that are constant within a block use no data bits,
+ * so most raw property columns cost only their chunk metadata. Names and
+ * architectures are dictionary encoded, so are stored as packed indices.
+ *
+ * The store is a single file that is memory-mapped for queries, with all
+ * fields little-endian:
+ *
+ *     +--------+------+------------------------------------------+
+ *     | Offset | Size | Field                                    |
+ *     +--------+------+------------------------------------------+
+ *     |      0 |    4 | Magic, the ASCII characters "MGPF"       |
+ *     |      4 |    2 | Format version, currently 1              |
+ *     |      6 |    2 | Number of columns                        |
+ *     |      8 |    4 | Rows per block                           |
+ *     |     12 |    4 | Number of blocks                         |
+ *     |     16 |    8 | Number of rows                           |
+ *     |     24 |    8 | Column table offset                      |
+ *     |     32 |    8 | Chunk table offset                       |
+ *     |     40 |    8 | Reserved, zero                           |
+ *     |     48 |    N | Chunk data, dictionaries, and tables     |
+ *     +--------+------+------------------------------------------+
+ *
+ * The column table has a 72 byte entry per column: a 32 byte NUL-padded name,
+ * the u32 column_type, the u32 dictionary entry count, the u64 minimum and
+ * maximum over all rows, and the u64 offset and size of the dictionary, which
+ * is a sequence of NUL-terminated strings. The chunk table has a 32 byte entry
+ * per column per block, in block-major order: the u64 data offset, the u64
+ * minimum and maximum of the chunk, the u32 bits per value, and a reserved
+ * u32. Chunk data is a sequence of u64 words, with value i of the chunk at bit
+ * i * bits, followed by one padding word.
+ *
+ * Stores are untrusted input; malformed stores are rejected when opened. Each
+ * chunk range must be within its column range, and use no more bits than the
+ * range needs. Packed values are not checked when opened, so queries ignore
+ * rows whose group key is outside the column range.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "libgpuinfo.hpp"
+#include "fleet/libgpuinfo_intern.hpp"
+
+namespace libarmgpuinfo {
+namespace fleet {
+
+/** Number of rows per block. */
+constexpr uint32_t block_rows { 16384 };
+
+/** Default number of distinct captures cached by a writer. */
+constexpr std::size_t default_cache_entries { 4096 };
+
+/** Storage type of a column. */
+enum class column_type : uint32_t {
+    /** Integer values */
+    integer = 0,
+    /** Indices into the column dictionary */
+    dictionary = 1
+};
+
+/** Description of a column. */
+struct column_info {
+    /** The column name. */
+    std::string name;
+
+    /** The storage type. */
+    column_type type;
+
+    /** The minimum value over all rows. */
+    uint64_t min;
+
+    /** The maximum value over all rows. */
+    uint64_t max;
+
+    /** The dictionary, for dictionary columns. */
+    std::vector<std::string> dictionary;
+};
+
+/**
+ * Writer that ingests captures into a new store.
+ *
+ * Rows are buffered one block at a time, so memory use does not depend on
+ * the number of rows. Captures are interned in a capture cache, so each
+ * distinct capture is decoded once.
+ */
+class writer {
+public:
+    /**
+     * Create a new store, replacing any existing file.
+     *
+     * @param path            The store file path.
+     * @param cache_entries   The maximum number of distinct captures to cache.
+     *
+     * @return The created writer, or @c nullptr on failure.
+     */
+    static std::unique_ptr<writer> create(
+        const std::string& path,
+        std::size_t cache_entries=default_cache_entries);
+
+    /**
+     * Add a device capture.
+     *
+     * @param capture        The capture data, as described in libgpuinfo_capture.hpp.
+     * @param size           The capture size in bytes.
+     * @param max_clock_hz   The maximum GPU clock of the device, in Hz, or zero if unknown.
+     *
+     * @return @c true if the capture was added, @c false if it could not be decoded.
+     */
+    bool add(const void* capture, std::size_t size, uint64_t max_clock_hz);
+
+    /**
+     * Write the remaining rows and the store metadata, and close the file.
+     *
+     * @return @c true if the store was written, @c false otherwise.
+     */
+    bool finish();
+
+    /** @return The number of rows added. */
+    uint64_t num_rows() const;
+
+    /** @return The capture cache statistics. */
+    capture_cache_stats get_cache_stats() const;
+
+    /** Destroy the writer, closing the file without finishing the store. */
+    ~writer();
+
+private:
+    struct impl;
+
+    explicit writer(std::unique_ptr<impl> state);
+
+    /** The writer state. */
+    std::unique_ptr<impl> impl_;
+};
+
+/** A memory-mapped store opened for queries. */
+class store {
+public:
+    /**
+     * Open a store.
+     *
+     * @param path   The store file path.
+     *
+     * @return The opened store, or @c nullptr if it cannot be read or is malformed.
+     */
+    static std::unique_ptr<store> open(const std::string& path);
+
+    /** @return The number of rows. */
+    uint64_t num_rows() const;
+
+    /** @return The number of blocks. */
+    uint32_t num_blocks() const;
+
+    /** @return The number of rows in a block. */
+    uint32_t get_block_rows(uint32_t block) const;
+
+    /** @return The column descriptions. */
+    const std::vector<column_info>& get_columns() const;
+
+    /**
+     * Find a column by name.
+     *
+     * @param name   The column name.
+     *
+     * @return The column index, or a negative value if not found.
+     */
+    int find_column(const std::string& name) const;
+
+    /**
+     * Get the value range of a column in a block.
+     *
+     * @param column   The column index.
+     * @param block    The block index.
+     * @param min      The returned minimum value.
+     * @param max      The returned maximum value.
+     * @param bits     The returned bits per packed value.
+     */
+    void get_chunk_range(uint32_t column, uint32_t block, uint64_t& min, uint64_t& max, uint32_t& bits) const;
+
+    /**
+     * Unpack the values of a column in a block.
+     *
+     * @param column   The column index.
+     * @param block    The block index.
+     * @param values   The returned values, with space for block_rows values.
+     *
+     * @return The number of values.
+     */
+    uint32_t read_chunk(uint32_t column, uint32_t block, uint64_t* values) const;
+
+    /** Destroy the store, unmapping the file. */
+    ~store();
+
+private:
+    struct impl;
+
+    explicit store(std::unique_ptr<impl> state);
+
+    /** The store state. */
+    std::unique_ptr<impl> impl_;
+};
+
+/** An inclusive range filter on a column. */
+struct range_filter {
+    /** The column name. */
+    std::string column;
+
+    /** The minimum accepted value. */
+    uint64_t min;
+
+    /** The maximum accepted value. */
+    uint64_t max;
+};
+
+/**
+ * An aggregate query.
+ *
+ * The metric is a column name, or one of the derived metrics fp32_gflops,
+ * fp16_gflops, and int8_gops, which are the peak rates of the whole GPU at
+ * the maximum clock, counting two operations per FMA or MAC.
+ */
+struct query {
+    /** The column to group rows by. */
+    std::string group_by;
+
+    /** The metric to aggregate. */
+    std::string metric;
+
+    /** The histogram bucket width, or zero for no histogram. */
+    uint64_t bucket_width;
+
+    /** The filters that a row must pass to be included. */
+    std::vector<range_filter> filters;
+};
+
+/** The aggregated metric of one group. */
+struct group_result {
+    /** The group key, the dictionary string or the decimal value. */
+    std::string key;
+
+    /** The number of rows. */
+    uint64_t count;
+
+    /** The minimum metric value. */
+    uint64_t min;
+
+    /** The maximum metric value. */
+    uint64_t max;
+
+    /** The sum of the metric values. */
+    uint64_t sum;
+
+    /** The number of rows in each histogram bucket, starting from zero. */
+    std::vector<uint64_t> buckets;
+};
+
+/** The result of an aggregate query. */
+struct query_result {
+    /** The groups, sorted by dictionary string or by integer value. */
+    std::vector<group_result> groups;
+
+    /** The number of blocks scanned. */
+    uint32_t num_blocks_scanned;
+
+    /** The number of blocks skipped using the chunk ranges of the filters. */
+    uint32_t num_blocks_skipped;
+};
+
+/**
+ * Run an aggregate query.
+ *
+ * Blocks that the chunk ranges show cannot pass the filters are skipped.
+ * Each remaining block is unpacked one column at a time into dense arrays,
+ * and the filters and metrics are evaluated with simple loops over them.
+ *
+ * @param db       The store.
+ * @param request  The query.
+ * @param result   The returned result.
+ *
+ * @return @c true if the query ran, @c false if a column or metric is unknown.
+ */
+bool run_query(
+    const store& db,
+    const query& request,
+    query_result& result);
+
+}
+}
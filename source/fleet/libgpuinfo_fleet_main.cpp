@@ -0,0 +1,701 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Command line tool for fleet stores.
+ *
+ * Usage:
+ *
+ *     libgpuinfo_fleet ingest <store> <manifest>
+ *     libgpuinfo_fleet ingest-stream <store> <stream> [max clock Hz]
+ *     libgpuinfo_fleet describe <store>
+ *     libgpuinfo_fleet query <store> <group column> <metric> [bucket width] [column=min:max ...]
+ *     libgpuinfo_fleet --verify-corpus <store>
+ *
+ * Each manifest line is a capture file path, optionally followed by the
+ * maximum GPU clock of the device in Hz. For example, the distribution of
+ * FP32 GFLOPS at the maximum clock by architecture, in 100 GFLOPS buckets:
+ *
+ *     libgpuinfo_fleet query fleet.mgpf architecture fp32_gflops 100
+ *
+ * A stream is a file of concatenated captures, such as a synthetic
+ * population written by libgpuinfo_population, and every device in it is
+ * given the same maximum clock.
+ *
+ * The verify mode ingests many copies of the synthetic device corpus, and
+ * checks the stored columns and query results against direct decoding.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fake_driver/libgpuinfo_corpus.hpp"
+#include "fake_driver/libgpuinfo_fake_driver.hpp"
+#include "fake_driver/libgpuinfo_population.hpp"
+#include "fleet/libgpuinfo_fleet.hpp"
+
+using namespace libarmgpuinfo;
+
+namespace {
+
+/** Number of copies of the corpus ingested by the verify mode. */
+constexpr uint32_t corpus_copies { 250 };
+
+/** Size of the stream read buffer, which must exceed the largest capture. */
+constexpr std::size_t stream_buffer_size { 64 * 1024 * 1024 };
+
+/** Size of a chunk table entry in a store. */
+constexpr std::size_t chunk_entry_size { 32 };
+
+/** @return A little-endian value read from the bytes of a store. */
+uint64_t load_bytes(const std::vector<char>& data, std::size_t offset, std::size_t size)
+{
+    uint64_t value { 0 };
+    for (std::size_t i = 0; i < size; i++) {
+        value |= uint64_t { static_cast<unsigned char>(data[offset + i]) } << (i * 8);
+    }
+
+    return value;
+}
+
+/** Write a little-endian value into the bytes of a store. */
+void store_bytes(std::vector<char>& data, std::size_t offset, uint64_t value, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; i++) {
+        data[offset + i] = static_cast<char>(value >> (i * 8));
+    }
+}
+
+/** @return The synthetic maximum clock of a verify mode row. */
+uint64_t get_corpus_clock(uint32_t copy, std::size_t index)
+{
+    return 500000000ULL + ((copy * 7 + index) % 8) * 100000000ULL;
+}
+
+/** Ingest the captures listed in a manifest. */
+int ingest(const std::string& path, const std::string& manifest)
+{
+    std::ifstream list(manifest);
+    if (!list) {
+        std::cerr << "ERROR: Failed to read " << manifest << "\n";
+        return EXIT_FAILURE;
+    }
+
+    auto db = fleet::writer::create(path);
+    if (!db) {
+        std::cerr << "ERROR: Failed to create " << path << "\n";
+        return EXIT_FAILURE;
+    }
+
+    uint64_t num_rejected { 0 };
+    std::string line;
+    while (std::getline(list, line)) {
+        std::istringstream fields(line);
+        std::string capture_path;
+        uint64_t max_clock_hz { 0 };
+        if (!(fields >> capture_path)) {
+            continue;
+        }
+
+        fields >> max_clock_hz;
+
+        std::ifstream in(capture_path, std::ios::binary);
+        const std::vector<char> capture {
+            std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+        if (!in || !db->add(capture.data(), capture.size(), max_clock_hz)) {
+            std::cerr << "WARNING: Failed to ingest " << capture_path << "\n";
+            num_rejected++;
+        }
+    }
+
+    const uint64_t num_rows = db->num_rows();
+    const auto stats = db->get_cache_stats();
+    if (!db->finish()) {
+        std::cerr << "ERROR: Failed to write " << path << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Ingested " << num_rows << " devices, rejected " << num_rejected
+              << ", decoded " << stats.num_misses << " distinct captures\n";
+    return EXIT_SUCCESS;
+}
+
+/** Ingest the captures in a stream file. */
+int ingest_stream(const std::string& path, const std::string& stream, uint64_t max_clock_hz)
+{
+    std::unique_ptr<FILE, int (*)(FILE*)> in { std::fopen(stream.c_str(), "rb"), std::fclose };
+    if (!in) {
+        std::cerr << "ERROR: Failed to read " << stream << "\n";
+        return EXIT_FAILURE;
+    }
+
+    auto db = fleet::writer::create(path);
+    if (!db) {
+        std::cerr << "ERROR: Failed to create " << path << "\n";
+        return EXIT_FAILURE;
+    }
+
+    // Read in large blocks, carrying any partial capture into the next block
+    std::vector<unsigned char> buffer(stream_buffer_size);
+    std::size_t buffered { 0 };
+    uint64_t num_rejected { 0 };
+    while (true) {
+        const std::size_t num_read = std::fread(buffer.data() + buffered, 1, buffer.size() - buffered, in.get());
+        buffered += num_read;
+
+        const unsigned char* data = buffer.data();
+        std::size_t remaining = buffered;
+        const unsigned char* capture { nullptr };
+        std::size_t capture_size { 0 };
+        while (fake::next_stream_capture(data, remaining, capture, capture_size)) {
+            if (!db->add(capture, capture_size, max_clock_hz)) {
+                num_rejected++;
+            }
+        }
+
+        std::memmove(buffer.data(), data, remaining);
+        buffered = remaining;
+        if (!num_read) {
+            break;
+        }
+    }
+
+    if (buffered) {
+        std::cerr << "ERROR: Truncated or malformed capture at the end of " << stream << "\n";
+        return EXIT_FAILURE;
+    }
+
+    const uint64_t num_rows = db->num_rows();
+    const auto stats = db->get_cache_stats();
+    if (!db->finish()) {
+        std::cerr << "ERROR: Failed to write " << path << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Ingested " << num_rows << " devices, rejected " << num_rejected
+              << ", decoded " << stats.num_misses << " distinct captures\n";
+    return EXIT_SUCCESS;
+}
+
+/** Describe the columns of a store. */
+int describe(const std::string& path)
+{
+    auto db = fleet::store::open(path);
+    if (!db) {
+        std::cerr << "ERROR: Failed to open " << path << "\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Rows: " << db->num_rows() << "\n";
+    std::cout << "Blocks: " << db->num_blocks() << "\n";
+
+    const auto& columns = db->get_columns();
+    for (uint32_t c = 0; c < columns.size(); c++) {
+        uint64_t total_bits { 0 };
+        for (uint32_t b = 0; b < db->num_blocks(); b++) {
+            uint64_t min { 0 };
+            uint64_t max { 0 };
+            uint32_t bits { 0 };
+            db->get_chunk_range(c, b, min, max, bits);
+            total_bits += uint64_t { bits } * db->get_block_rows(b);
+        }
+
+        const auto& column = columns[c];
+        const double mean_bits = db->num_rows() ? double(total_bits) / double(db->num_rows()) : 0.0;
+        std::cout << "  " << column.name << ": min=" << column.min << " max=" << column.max
+                  << " bits=" << mean_bits;
+        if (column.type == fleet::column_type::dictionary) {
+            std::cout << " entries=" << column.dictionary.size();
+        }
+
+        std::cout << "\n";
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/** Parse a column=min:max filter. */
+bool parse_filter(const std::string& text, fleet::range_filter& filter)
+{
+    const auto equals = text.find('=');
+    const auto colon = text.find(':', equals);
+    if ((equals == std::string::npos) || (colon == std::string::npos)) {
+        return false;
+    }
+
+    filter.column = text.substr(0, equals);
+    filter.min = std::strtoull(text.c_str() + equals + 1, nullptr, 0);
+    filter.max = std::strtoull(text.c_str() + colon + 1, nullptr, 0);
+    return true;
+}
+
+/** Print a query result. */
+void print_result(const fleet::query& request, const fleet::query_result& result)
+{
+    std::cout << "Blocks scanned: " << result.num_blocks_scanned
+              << ", skipped: " << result.num_blocks_skipped << "\n";
+
+    for (const auto& group : result.groups) {
+        std::cout << group.key << ": count=" << group.count
+                  << " min=" << group.min
+                  << " mean=" << (group.sum / group.count)
+                  << " max=" << group.max << "\n";
+
+        for (std::size_t i = 0; i < group.buckets.size(); i++) {
+            if (group.buckets[i]) {
+                std::cout << "    [" << (i * request.bucket_width) << ", "
+                          << ((i + 1) * request.bucket_width) << "): "
+                          << group.buckets[i] << "\n";
+            }
+        }
+    }
+}
+
+/** Run an aggregate query. */
+int run(const std::string& path, int argc, char* argv[])
+{
+    auto db = fleet::store::open(path);
+    if (!db) {
+        std::cerr << "ERROR: Failed to open " << path << "\n";
+        return EXIT_FAILURE;
+    }
+
+    fleet::query request {};
+    request.group_by = argv[0];
+    request.metric = argv[1];
+    for (int i = 2; i < argc; i++) {
+        fleet::range_filter filter {};
+        if (parse_filter(argv[i], filter)) {
+            request.filters.push_back(filter);
+        } else if (i == 2) {
+            request.bucket_width = std::strtoull(argv[i], nullptr, 0);
+        } else {
+            std::cerr << "ERROR: Invalid filter " << argv[i] << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    fleet::query_result result;
+    if (!fleet::run_query(*db, request, result)) {
+        std::cerr << "ERROR: Unknown column or metric\n";
+        return EXIT_FAILURE;
+    }
+
+    print_result(request, result);
+    return EXIT_SUCCESS;
+}
+
+/** Check a query result against groups computed directly from the decoded rows. */
+bool check_query(
+    const fleet::store& db,
+    const fleet::query& request,
+    const std::map<std::string, fleet::group_result>& expected,
+    uint32_t expected_skipped
+) {
+    fleet::query_result result;
+    if (!fleet::run_query(db, request, result)) {
+        std::cerr << "ERROR: Query " << request.metric << " failed\n";
+        return false;
+    }
+
+    bool pass = (result.groups.size() == expected.size()) &&
+                (result.num_blocks_skipped == expected_skipped) &&
+                ((result.num_blocks_scanned + result.num_blocks_skipped) == db.num_blocks());
+
+    for (const auto& group : result.groups) {
+        const auto it = expected.find(group.key);
+        pass = pass && (it != expected.end()) &&
+               (group.count == it->second.count) &&
+               (group.min == it->second.min) &&
+               (group.max == it->second.max) &&
+               (group.sum == it->second.sum) &&
+               (group.buckets == it->second.buckets);
+    }
+
+    if (!pass) {
+        std::cerr << "ERROR: Query " << request.metric << " by " << request.group_by
+                  << " does not match the decoded corpus\n";
+    }
+
+    return pass;
+}
+
+/** Add a value to an expected group result. */
+void add_expected(fleet::group_result& group, uint64_t value, uint64_t bucket_width)
+{
+    group.min = group.count ? std::min(group.min, value) : value;
+    group.max = group.count ? std::max(group.max, value) : value;
+    group.sum += value;
+    group.count++;
+
+    if (bucket_width) {
+        const uint64_t bucket = value / bucket_width;
+        if (bucket >= group.buckets.size()) {
+            group.buckets.resize(bucket + 1);
+        }
+
+        group.buckets[bucket]++;
+    }
+}
+
+/**
+ * Verify the capture cache when used from several threads, with a cache that
+ * holds every capture and with a cache that must evict captures, and verify
+ * the caching of captures that cannot be decoded.
+ */
+bool verify_cache(
+    const std::vector<fake::corpus_case>& corpus,
+    const std::vector<std::vector<unsigned char>>& captures,
+    const std::vector<gpuinfo>& infos
+) {
+    constexpr uint32_t num_threads { 8 };
+    constexpr uint32_t num_passes { 4 };
+
+    for (std::size_t cache_entries : { fleet::default_cache_entries, std::size_t { 32 } }) {
+        fleet::capture_cache cache { cache_entries };
+        std::vector<std::vector<std::shared_ptr<const fleet::interned_capture>>> handles(num_threads);
+        std::vector<std::thread> threads;
+
+        // Each thread visits the captures in a different order
+        for (uint32_t t = 0; t < num_threads; t++) {
+            threads.emplace_back([&cache, &captures, &handles, t] {
+                handles[t].resize(captures.size());
+                for (uint32_t pass = 0; pass < num_passes; pass++) {
+                    for (std::size_t i = 0; i < captures.size(); i++) {
+                        const std::size_t index = (i * (2 * t + 1) + pass) % captures.size();
+                        handles[t][index] = cache.intern(captures[index].data(), captures[index].size());
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        const auto stats = cache.get_stats();
+        bool pass = stats.num_entries <= cache_entries;
+        for (uint32_t t = 0; t < num_threads; t++) {
+            for (std::size_t i = 0; i < captures.size(); i++) {
+                const auto& handle = handles[t][i];
+                pass = pass && handle &&
+                       (fake::format_info(handle->info) == fake::format_info(infos[i])) &&
+                       (handle->data == captures[i]);
+
+                // Without evictions, every thread shares the same handle for the same data
+                const auto& first = handles[0][std::distance(captures.begin(),
+                    std::find(captures.begin(), captures.end(), captures[i]))];
+                pass = pass && (stats.num_evictions || (handle == first));
+            }
+        }
+
+        if (!pass) {
+            std::cerr << "ERROR: Capture cache with " << cache_entries << " entries does not match "
+                      << corpus.size() << " corpus cases\n";
+            return false;
+        }
+    }
+
+    // A truncated capture cannot be decoded, but is cached so that it is only
+    // decoded once, and a cache with no entries decodes every lookup
+    const auto& capture = captures.front();
+    const std::size_t malformed_size = capture.size() / 2;
+    for (std::size_t cache_entries : { std::size_t { 32 }, std::size_t { 0 } }) {
+        fleet::capture_cache cache { cache_entries };
+        bool pass { true };
+        for (uint32_t i = 0; i < num_passes; i++) {
+            pass = pass && !cache.intern(capture.data(), malformed_size);
+            pass = pass && cache.intern(capture.data(), capture.size());
+        }
+
+        const auto stats = cache.get_stats();
+        const uint64_t num_entries = cache_entries ? 2 : 0;
+        const uint64_t num_misses = cache_entries ? 2 : (2 * num_passes);
+        if (!pass || (stats.num_entries != num_entries) || (stats.num_misses != num_misses)) {
+            std::cerr << "ERROR: Capture cache with " << cache_entries << " entries decoded "
+                      << stats.num_misses << " captures, expected " << num_misses << "\n";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** Ingest copies of the corpus, and verify the store and queries. */
+int verify_corpus(const std::string& path)
+{
+    const auto corpus = fake::make_corpus();
+
+    std::vector<std::vector<unsigned char>> captures;
+    std::vector<gpuinfo> infos;
+    for (const auto& test : corpus) {
+        captures.push_back(fake::encode_capture(test.gpu));
+        gpuinfo info {};
+        if (!decode_capture(captures.back().data(), captures.back().size(), info)) {
+            std::cerr << "ERROR: Failed to decode " << test.name << "\n";
+            return EXIT_FAILURE;
+        }
+
+        infos.push_back(info);
+    }
+
+    auto out = fleet::writer::create(path);
+    if (!out) {
+        std::cerr << "ERROR: Failed to create " << path << "\n";
+        return EXIT_FAILURE;
+    }
+
+    for (uint32_t copy = 0; copy < corpus_copies; copy++) {
+        for (std::size_t i = 0; i < captures.size(); i++) {
+            if (!out->add(captures[i].data(), captures[i].size(), get_corpus_clock(copy, i))) {
+                std::cerr << "ERROR: Failed to ingest " << corpus[i].name << "\n";
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // Each distinct capture is decoded once
+    const std::set<std::vector<unsigned char>> distinct(captures.begin(), captures.end());
+    const auto stats = out->get_cache_stats();
+    if ((stats.num_misses != distinct.size()) || (stats.num_evictions != 0)) {
+        std::cerr << "ERROR: Decoded " << stats.num_misses << " captures, expected "
+                  << distinct.size() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    if (!out->finish()) {
+        std::cerr << "ERROR: Failed to write " << path << "\n";
+        return EXIT_FAILURE;
+    }
+
+    if (!verify_cache(corpus, captures, infos)) {
+        return EXIT_FAILURE;
+    }
+
+    auto db = fleet::store::open(path);
+    const uint64_t num_rows = uint64_t { corpus_copies } * corpus.size();
+    if (!db || (db->num_rows() != num_rows) || (db->num_blocks() < 2)) {
+        std::cerr << "ERROR: Failed to reopen " << path << "\n";
+        return EXIT_FAILURE;
+    }
+
+    // Every row of the key columns matches direct decoding
+    const int name_column = db->find_column("name");
+    const int id_column = db->find_column("gpu_id");
+    const int mask_column = db->find_column("shader_core_mask");
+    const int clock_column = db->find_column("max_clock_hz");
+    if ((name_column < 0) || (id_column < 0) || (mask_column < 0) || (clock_column < 0)) {
+        std::cerr << "ERROR: Missing key columns\n";
+        return EXIT_FAILURE;
+    }
+
+    const auto& names = db->get_columns()[name_column].dictionary;
+    std::vector<uint64_t> name_values(fleet::block_rows);
+    std::vector<uint64_t> id_values(fleet::block_rows);
+    std::vector<uint64_t> mask_values(fleet::block_rows);
+    std::vector<uint64_t> clock_values(fleet::block_rows);
+    uint64_t row { 0 };
+    for (uint32_t b = 0; b < db->num_blocks(); b++) {
+        const uint32_t count = db->read_chunk(name_column, b, name_values.data());
+        db->read_chunk(id_column, b, id_values.data());
+        db->read_chunk(mask_column, b, mask_values.data());
+        db->read_chunk(clock_column, b, clock_values.data());
+
+        for (uint32_t i = 0; i < count; i++, row++) {
+            const std::size_t index = row % corpus.size();
+            const uint32_t copy = static_cast<uint32_t>(row / corpus.size());
+            const gpuinfo& info = infos[index];
+            if ((names[name_values[i]] != info.gpu_name) ||
+                (id_values[i] != info.gpu_id) ||
+                (mask_values[i] != info.shader_core_mask) ||
+                (clock_values[i] != get_corpus_clock(copy, index))) {
+                std::cerr << "ERROR: Row " << row << " does not match " << corpus[index].name << "\n";
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // Query results match direct computation, with and without filters
+    fleet::query distribution {};
+    distribution.group_by = "architecture";
+    distribution.metric = "fp32_gflops";
+    distribution.bucket_width = 100;
+
+    fleet::query filtered = distribution;
+    filtered.filters.push_back({ "max_clock_hz", 800000000, 1000000000 });
+    filtered.filters.push_back({ "num_shader_cores", 8, 64 });
+
+    fleet::query skipped = distribution;
+    skipped.filters.push_back({ "num_shader_cores", 1000, 2000 });
+
+    std::map<std::string, fleet::group_result> expected_distribution;
+    std::map<std::string, fleet::group_result> expected_filtered;
+    for (uint64_t r = 0; r < num_rows; r++) {
+        const std::size_t index = r % corpus.size();
+        const gpuinfo& info = infos[index];
+        const uint64_t clock = get_corpus_clock(static_cast<uint32_t>(r / corpus.size()), index);
+        const uint64_t gflops =
+            (uint64_t { info.num_fp32_fmas_per_cy } * info.num_shader_cores * 2 * (clock / 1000)) / 1000000;
+
+        add_expected(expected_distribution[info.architecture_name], gflops, distribution.bucket_width);
+        if ((clock >= 800000000) && (clock <= 1000000000) &&
+            (info.num_shader_cores >= 8) && (info.num_shader_cores <= 64)) {
+            add_expected(expected_filtered[info.architecture_name], gflops, filtered.bucket_width);
+        }
+    }
+
+    if (!check_query(*db, distribution, expected_distribution, 0) ||
+        !check_query(*db, filtered, expected_filtered, 0) ||
+        !check_query(*db, skipped, {}, db->num_blocks())) {
+        return EXIT_FAILURE;
+    }
+
+    // A truncated store is rejected
+    std::ifstream in(path, std::ios::binary);
+    const std::vector<char> data {
+        std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+    const std::string truncated_path = path + ".truncated";
+    std::ofstream(truncated_path, std::ios::binary).write(data.data(), data.size() - 1);
+    if (fleet::store::open(truncated_path)) {
+        std::cerr << "ERROR: Truncated store was not rejected\n";
+        return EXIT_FAILURE;
+    }
+
+    // A chunk range outside its column range is rejected, as is a chunk that
+    // uses more bits than its range needs. Chunk entries are block-major, so
+    // the entry of a column in the first block is at its column index
+    const std::size_t chunk_table = load_bytes(data, 32, 8);
+    const int architecture = db->find_column("architecture");
+    const std::size_t architecture_entry = chunk_table + architecture * chunk_entry_size;
+
+    std::vector<char> corrupt = data;
+    store_bytes(corrupt, architecture_entry + 8, 100000000, 8);
+    store_bytes(corrupt, architecture_entry + 16, 100000000, 8);
+    store_bytes(corrupt, architecture_entry + 24, 0, 4);
+    const std::string corrupt_path = path + ".corrupt";
+    std::ofstream(corrupt_path, std::ios::binary).write(corrupt.data(), corrupt.size());
+    if (fleet::store::open(corrupt_path)) {
+        std::cerr << "ERROR: Chunk range outside the column range was not rejected\n";
+        return EXIT_FAILURE;
+    }
+
+    corrupt = data;
+    store_bytes(corrupt, architecture_entry + 24, load_bytes(data, architecture_entry + 24, 4) + 1, 4);
+    std::ofstream(corrupt_path, std::ios::binary).write(corrupt.data(), corrupt.size());
+    if (fleet::store::open(corrupt_path)) {
+        std::cerr << "ERROR: Chunk with excess bits was not rejected\n";
+        return EXIT_FAILURE;
+    }
+
+    // Packed values above the column range are ignored by queries. The name
+    // chunk of the first block is moved to the top of the column range, and
+    // its values set to all ones, so every group key in it is out of range
+    const int name = db->find_column("name");
+    const uint64_t name_max = db->get_columns()[name].max;
+    uint64_t chunk_min, chunk_max;
+    uint32_t chunk_bits;
+    db->get_chunk_range(name, 0, chunk_min, chunk_max, chunk_bits);
+    if ((chunk_bits < 2) || (db->num_blocks() < 2)) {
+        std::cerr << "ERROR: Corpus is too small to corrupt a name chunk\n";
+        return EXIT_FAILURE;
+    }
+
+    const std::size_t name_entry = chunk_table + name * chunk_entry_size;
+    const std::size_t name_offset = load_bytes(data, name_entry, 8);
+    const std::size_t name_bytes = ((std::size_t { fleet::block_rows } * chunk_bits + 63) / 64) * 8;
+    corrupt = data;
+    store_bytes(corrupt, name_entry + 8, name_max - (uint64_t { 1 } << (chunk_bits - 1)), 8);
+    store_bytes(corrupt, name_entry + 16, name_max, 8);
+    std::fill(corrupt.begin() + name_offset, corrupt.begin() + name_offset + name_bytes, '\xff');
+    std::ofstream(corrupt_path, std::ios::binary).write(corrupt.data(), corrupt.size());
+
+    const auto corrupt_db = fleet::store::open(corrupt_path);
+    fleet::query by_name = distribution;
+    by_name.group_by = "name";
+    fleet::query_result corrupt_result;
+    if (!corrupt_db || !fleet::run_query(*corrupt_db, by_name, corrupt_result)) {
+        std::cerr << "ERROR: Query of a store with corrupt values failed\n";
+        return EXIT_FAILURE;
+    }
+
+    uint64_t corrupt_rows { 0 };
+    for (const auto& group : corrupt_result.groups) {
+        corrupt_rows += group.count;
+    }
+
+    if (corrupt_rows != (num_rows - fleet::block_rows)) {
+        std::cerr << "ERROR: Query counted " << corrupt_rows << " rows with corrupt values\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "PASS: " << num_rows << " rows in " << db->num_blocks()
+              << " blocks match the decoded corpus\n";
+    return EXIT_SUCCESS;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    const std::string mode { (argc > 1) ? argv[1] : "" };
+
+    if ((mode == "ingest") && (argc == 4)) {
+        return ingest(argv[2], argv[3]);
+    }
+
+    if ((mode == "ingest-stream") && ((argc == 4) || (argc == 5))) {
+        return ingest_stream(argv[2], argv[3], (argc == 5) ? std::strtoull(argv[4], nullptr, 0) : 0);
+    }
+
+    if ((mode == "describe") && (argc == 3)) {
+        return describe(argv[2]);
+    }
+
+    if ((mode == "query") && (argc >= 5)) {
+        return run(argv[2], argc - 3, argv + 3);
+    }
+
+    if ((mode == "--verify-corpus") && (argc == 3)) {
+        return verify_corpus(argv[2]);
+    }
+
+    std::cerr << "Usage: libgpuinfo_fleet ingest <store> <manifest>\n"
+              << "       libgpuinfo_fleet ingest-stream <store> <stream> [max clock Hz]\n"
+              << "       libgpuinfo_fleet describe <store>\n"
+              << "       libgpuinfo_fleet query <store> <group column> <metric> [bucket width] [column=min:max ...]\n"
+              << "       libgpuinfo_fleet --verify-corpus <store>\n";
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "fleet/libgpuinfo_intern.hpp"
+
+namespace libarmgpuinfo {
+namespace fleet {
+
+namespace {
+
+using detail::load_le;
+
+/** Maximum number of shards, which limits lock contention between threads. */
+constexpr std::size_t max_shards { 16 };
+
+/** Minimum number of entries per shard. */
+constexpr std::size_t min_shard_entries { 64 };
+
+/**
+ * Read the raw properties of a post-r21 property buffer.
+ *
+ * @param data    The property buffer.
+ * @param size    The property buffer size in bytes.
+ * @param props   The returned values, indexed by property code.
+ */
+void read_raw_props(
+    const unsigned char* data,
+    std::size_t size,
+    uint64_t (&props)[max_prop_code + 1]
+) {
+    while (size >= sizeof(uint32_t)) {
+        const uint32_t key = load_le<uint32_t>(data);
+        const uint32_t code = key >> 2;
+        const std::size_t value_size = std::size_t { 1 } << (key & 0x3);
+        data += sizeof(uint32_t);
+        size -= sizeof(uint32_t);
+        if (size < value_size) {
+            return;
+        }
+
+        uint64_t value { 0 };
+        for (std::size_t b = 0; b < value_size; b++) {
+            value |= static_cast<uint64_t>(data[b]) << (8 * b);
+        }
+
+        if (code <= max_prop_code) {
+            props[code] = value;
+        }
+
+        data += value_size;
+        size -= value_size;
+    }
+}
+
+/** @return @c true if a cached capture has the given data. */
+bool has_data(
+    const interned_capture& entry,
+    const unsigned char* data,
+    std::size_t size
+) {
+    return (entry.data.size() == size) && (std::memcmp(entry.data.data(), data, size) == 0);
+}
+
+/** @return The capture handle, or @c nullptr if the capture cannot be decoded. */
+std::shared_ptr<const interned_capture> get_valid(
+    std::shared_ptr<const interned_capture> entry
+) {
+    return entry->valid ? entry : nullptr;
+}
+
+}
+
+/** A cache shard, with its own lock and eviction order. */
+struct capture_cache::shard {
+    using entry_list = std::list<std::shared_ptr<const interned_capture>>;
+
+    /** The lock that protects the shard state. */
+    std::mutex lock;
+
+    /** The cached captures, most recently used first. */
+    entry_list entries;
+
+    /** The cached captures, by hash. */
+    std::unordered_map<uint64_t, entry_list::iterator> index;
+
+    /** The maximum number of cached captures. */
+    std::size_t max_entries { 0 };
+
+    /** Statistics. */
+    uint64_t num_hits { 0 };
+    uint64_t num_misses { 0 };
+    uint64_t num_evictions { 0 };
+
+    /**
+     * Find a cached capture, and mark it as most recently used.
+     *
+     * Must be called with the lock held.
+     *
+     * @return The cached capture, or @c nullptr if the hash is not cached or
+     *         the cached capture with the hash has different data.
+     */
+    std::shared_ptr<const interned_capture> find(
+        uint64_t hash,
+        const unsigned char* data,
+        std::size_t size
+    ) {
+        auto it = index.find(hash);
+        if ((it == index.end()) || !has_data(**it->second, data, size)) {
+            return nullptr;
+        }
+
+        entries.splice(entries.begin(), entries, it->second);
+        return *it->second;
+    }
+};
+
+/* See header for documentation */
+capture_cache::capture_cache(std::size_t max_entries)
+{
+    // Small caches use fewer shards, so each shard holds a useful number of entries
+    const std::size_t num_shards = max_entries / min_shard_entries;
+    num_shards_ = (num_shards < 1) ? 1 : ((num_shards > max_shards) ? max_shards : num_shards);
+
+    shards_.reset(new shard[num_shards_]);
+    for (std::size_t i = 0; i < num_shards_; i++) {
+        shards_[i].max_entries = max_entries / num_shards_ + ((i < (max_entries % num_shards_)) ? 1 : 0);
+    }
+}
+
+/* See header for documentation */
+capture_cache::~capture_cache() = default;
+
+/* See header for documentation */
+std::shared_ptr<const interned_capture> capture_cache::intern(const void* capture, std::size_t size)
+{
+    const auto* data = static_cast<const unsigned char*>(capture);
+    if (!data) {
+        return nullptr;
+    }
+
+    const uint64_t hash = hash_capture(data, size);
+    shard& s = shards_[hash % num_shards_];
+
+    {
+        std::lock_guard<std::mutex> guard(s.lock);
+        auto cached = s.find(hash, data, size);
+        if (cached) {
+            s.num_hits++;
+            return get_valid(cached);
+        }
+    }
+
+    // Decode outside the lock, so other threads are not blocked. Failed
+    // decodes are cached too, so a repeated malformed capture is decoded once
+    auto decoded = std::make_shared<interned_capture>();
+    decoded->hash = hash;
+    decoded->data.assign(data, data + size);
+    decoded->valid = decode_capture(data, size, decoded->info);
+    if (decoded->valid) {
+        detail::capture_view view {};
+        detail::parse_capture(data, size, view);
+        decoded->kernel = view.kernel;
+        if (view.kernel != detail::capture_kernel::pre_r21) {
+            read_raw_props(view.payload, view.payload_size, decoded->raw_props);
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(s.lock);
+    s.num_misses++;
+
+    // Another thread may have decoded the same capture concurrently
+    auto cached = s.find(hash, data, size);
+    if (cached) {
+        return get_valid(cached);
+    }
+
+    // A different capture with the same hash keeps its entry, and a cache
+    // with no entries caches nothing
+    if (s.index.count(hash) || !s.max_entries) {
+        return get_valid(decoded);
+    }
+
+    s.entries.push_front(decoded);
+    s.index[hash] = s.entries.begin();
+    if (s.entries.size() > s.max_entries) {
+        s.index.erase(s.entries.back()->hash);
+        s.entries.pop_back();
+        s.num_evictions++;
+    }
+
+    return get_valid(decoded);
+}
+
+/* See header for documentation */
+capture_cache_stats capture_cache::get_stats() const
+{
+    capture_cache_stats stats {};
+    for (std::size_t i = 0; i < num_shards_; i++) {
+        shard& s = shards_[i];
+        std::lock_guard<std::mutex> guard(s.lock);
+        stats.num_hits += s.num_hits;
+        stats.num_misses += s.num_misses;
+        stats.num_evictions += s.num_evictions;
+        stats.num_entries += s.entries.size();
+    }
+
+    return stats;
+}
+
+/* See header for documentation */
+uint64_t hash_capture(const unsigned char* data, std::size_t size)
+{
+    // A multiply-xorshift hash over 64-bit words
+    constexpr uint64_t seed { 0x9e3779b97f4a7c15ULL };
+    constexpr uint64_t multiplier { 0xff51afd7ed558ccdULL };
+
+    uint64_t hash = seed ^ size;
+    std::size_t i { 0 };
+    for (; (i + sizeof(uint64_t)) <= size; i += sizeof(uint64_t)) {
+        hash = (hash ^ load_le<uint64_t>(data + i)) * multiplier;
+        hash ^= hash >> 32;
+    }
+
+    uint64_t tail { 0 };
+    for (std::size_t b = 0; i < size; i++, b++) {
+        tail |= static_cast<uint64_t>(data[i]) << (8 * b);
+    }
+
+    hash = (hash ^ tail) * multiplier;
+    return hash ^ (hash >> 29);
+}
+
+}
+}
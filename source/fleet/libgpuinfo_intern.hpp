@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Interning of decoded device captures.
+ *
+ * Fleet reports are dominated by a small number of distinct device
+ * configurations, so most captures are byte-identical to one seen before.
+ * The capture cache hashes each capture, decodes each distinct capture once,
+ * and returns a shared immutable handle to the decoded result, so the cost
+ * of bulk processing scales with the number of distinct configurations
+ * rather than with the number of reports.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "libgpuinfo.hpp"
+#include "libgpuinfo_capture.hpp"
+
+namespace libarmgpuinfo {
+namespace fleet {
+
+/** The last raw property code that is retained, the last code defined by current kbase drivers. */
+constexpr uint32_t max_prop_code { 85 };
+
+/** An immutable decoded capture, shared by every capture with the same data. */
+struct interned_capture {
+    /** The hash of the capture data. */
+    uint64_t hash;
+
+    /** The capture data. */
+    std::vector<unsigned char> data;
+
+    /**
+     * @c true if the capture was decoded. Captures that cannot be decoded are
+     * cached so they are not decoded again, but only the hash and data are set.
+     */
+    bool valid;
+
+    /** The kernel driver interface of the capture. */
+    detail::capture_kernel kernel;
+
+    /** The decoded GPU information. */
+    gpuinfo info;
+
+    /** The raw post-r21 property values, indexed by property code, or zero if not reported. */
+    uint64_t raw_props[max_prop_code + 1];
+};
+
+/** Capture cache statistics. */
+struct capture_cache_stats {
+    /** The number of lookups that found a cached capture. */
+    uint64_t num_hits;
+
+    /** The number of lookups that decoded a capture, including failed decodes. */
+    uint64_t num_misses;
+
+    /** The number of captures evicted to stay within the size limit. */
+    uint64_t num_evictions;
+
+    /** The number of cached captures, including captures that cannot be decoded. */
+    uint64_t num_entries;
+};
+
+/**
+ * A bounded cache of decoded captures, keyed by capture hash.
+ *
+ * The cache is safe to use from multiple threads. It is split into shards
+ * by hash, each with its own lock and least recently used eviction, and
+ * captures are decoded outside the lock. Handles remain valid after the
+ * capture is evicted. Captures that cannot be decoded are cached too, so a
+ * repeated malformed capture is only decoded once.
+ */
+class capture_cache {
+public:
+    /**
+     * Create a cache.
+     *
+     * @param max_entries   The maximum number of cached captures. Zero
+     *                      disables caching, so every capture is decoded.
+     */
+    explicit capture_cache(std::size_t max_entries);
+
+    /** Destroy the cache. */
+    ~capture_cache();
+
+    /**
+     * Get the decoded result of a capture, decoding it if not cached.
+     *
+     * @param capture   The capture data, as described in libgpuinfo_capture.hpp.
+     * @param size      The capture size in bytes.
+     *
+     * @return The shared decoded capture, or @c nullptr if it cannot be decoded.
+     */
+    std::shared_ptr<const interned_capture> intern(const void* capture, std::size_t size);
+
+    /** @return The cache statistics. */
+    capture_cache_stats get_stats() const;
+
+private:
+    struct shard;
+
+    /** The number of shards. */
+    std::size_t num_shards_;
+
+    /** The shards. */
+    std::unique_ptr<shard[]> shards_;
+};
+
+/**
+ * Hash capture data.
+ *
+ * @param data   The capture data.
+ * @param size   The capture size in bytes.
+ *
+ * @return The 64-bit hash.
+ */
+uint64_t hash_capture(const unsigned char* data, std::size_t size);
+
+}
+}
@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include <sys/stat.h>
+
+#include "libgpuinfo.hpp"
+#include "libgpuinfo_capture.hpp"
+#include "libgpuinfo_decoder.hpp"
+#include "libgpuinfo_kbase.hpp"
+#include "fuzz/libgpuinfo_fuzz.hpp"
+
+namespace {
+
+/** Heap usage tracking, enabled only while a target is running. */
+bool tracking { false };
+std::size_t live_bytes { 0 };
+std::size_t peak_bytes { 0 };
+
+/** Allocation header storing the allocation size, keeping max alignment. */
+constexpr std::size_t header_size { alignof(std::max_align_t) };
+
+void* tracked_alloc(std::size_t size) noexcept
+{
+    auto* block = static_cast<unsigned char*>(std::malloc(size + header_size));
+    if (!block) {
+        return nullptr;
+    }
+
+    std::memcpy(block, &size, sizeof(size));
+    if (tracking) {
+        live_bytes += size;
+        if (live_bytes > peak_bytes) {
+            peak_bytes = live_bytes;
+        }
+    }
+
+    return block + header_size;
+}
+
+void tracked_free(void* ptr) noexcept
+{
+    if (!ptr) {
+        return;
+    }
+
+    auto* block = static_cast<unsigned char*>(ptr) - header_size;
+    std::size_t size { 0 };
+    std::memcpy(&size, block, sizeof(size));
+    if (tracking) {
+        live_bytes = (size < live_bytes) ? (live_bytes - size) : 0;
+    }
+
+    std::free(block);
+}
+
+/** Budget per input byte, and fixed budget per run. */
+constexpr uint64_t time_ns_per_byte { 1000 };
+constexpr uint64_t time_ns_fixed { 10 * 1000 * 1000 };
+constexpr std::size_t heap_bytes_per_byte { 2 };
+constexpr std::size_t heap_bytes_fixed { 128 * 1024 };
+
+/** Number of times an over-budget run is retried before it is reported. */
+constexpr int max_retries { 2 };
+
+/** The input of the running post-r21 query target. */
+const uint8_t* query_data { nullptr };
+std::size_t query_size { 0 };
+
+/** Fake file descriptor of the query target device. */
+constexpr int query_fd { 3 };
+
+/** Read a signed 32-bit size field of the query target input. */
+int get_query_size(std::size_t offset)
+{
+    if (query_size < offset + 4) {
+        return 0;
+    }
+
+    return static_cast<int>(libarmgpuinfo::detail::load_le<uint32_t>(query_data + offset));
+}
+
+int query_open(const char* path, int flags)
+{
+    (void)path;
+    (void)flags;
+    return query_fd;
+}
+
+int query_close(int fd)
+{
+    (void)fd;
+    return 0;
+}
+
+int query_fstat(int fd, struct stat* buf)
+{
+    (void)fd;
+    std::memset(buf, 0, sizeof(*buf));
+    buf->st_mode = S_IFCHR;
+    return 0;
+}
+
+int query_ioctl(int fd, unsigned long request, void* arg)
+{
+    using namespace libarmgpuinfo;
+    (void)fd;
+
+    switch (request) {
+    case kbase_post_r21::version_check_jm: {
+        auto* check = static_cast<kbase_post_r21::version_check_t*>(arg);
+        check->major = 11;
+        check->minor = 40;
+        return 0;
+    }
+    case kbase_post_r21::set_flags:
+        return 0;
+    case kbase_post_r21::get_gpuprops: {
+        auto* props = static_cast<kbase_post_r21::get_gpuprops_t*>(arg);
+        if (props->size == 0) {
+            return get_query_size(0);
+        }
+
+        // Copy the payload, but never beyond the buffer the caller provided
+        std::size_t payload_size = (query_size > 8) ? (query_size - 8) : 0;
+        std::size_t copy_size = (payload_size < props->size) ? payload_size : props->size;
+        if (copy_size) {
+            std::memcpy(props->buffer.get(), query_data + 8, copy_size);
+        }
+
+        return get_query_size(4);
+    }
+    default:
+        errno = EINVAL;
+        return -1;
+    }
+}
+
+constexpr libarmgpuinfo::driver_interface query_driver {
+    query_open,
+    query_close,
+    query_fstat,
+    query_ioctl,
+    nullptr
+};
+
+/** Run a target without measurement. */
+void run_target_body(
+    libarmgpuinfo::fuzz::target tgt,
+    const uint8_t* data,
+    std::size_t size
+) {
+    using namespace libarmgpuinfo;
+
+    switch (tgt) {
+    case fuzz::target::post_r21_decoder: {
+        gpuinfo info {};
+        detail::prop_decoder decoder { data, size };
+        if (decoder.decode(info)) {
+            detail::finalize_info(info);
+        }
+        break;
+    }
+    case fuzz::target::pre_r21_decoder: {
+        // Pad or truncate the input to a complete structure
+        unsigned char buffer[detail::pre_r21_props_size] {};
+        std::memcpy(buffer, data, (size < sizeof(buffer)) ? size : sizeof(buffer));
+
+        kbase_pre_r21::uk_gpuprops_t props {};
+        detail::pre_r21_reader reader { buffer, sizeof(buffer) };
+        if (reader.read(props)) {
+            gpuinfo info {};
+            detail::decode_pre_r21_props(props, info);
+            detail::finalize_info(info);
+        }
+        break;
+    }
+    case fuzz::target::capture: {
+        gpuinfo info {};
+        decode_capture(data, size, info);
+        break;
+    }
+    case fuzz::target::post_r21_query: {
+        query_data = data;
+        query_size = size;
+        auto inst = instance::create(0, query_driver);
+        query_data = nullptr;
+        query_size = 0;
+        break;
+    }
+    }
+}
+
+}
+
+/*
+ * Heap usage tracking replaces the global allocation functions. Allocation
+ * failure is fatal in the harness, so it also works without exceptions.
+ */
+void* operator new(std::size_t size)
+{
+    void* ptr = tracked_alloc(size);
+    if (!ptr) {
+        std::abort();
+    }
+
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return tracked_alloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return tracked_alloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    tracked_free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    tracked_free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    tracked_free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    tracked_free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    tracked_free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    tracked_free(ptr);
+}
+
+namespace libarmgpuinfo {
+namespace fuzz {
+
+/* See header for documentation */
+const char* get_target_name(
+    target tgt
+) {
+    switch (tgt) {
+    case target::post_r21_decoder:
+        return "post_r21_decoder";
+    case target::pre_r21_decoder:
+        return "pre_r21_decoder";
+    case target::capture:
+        return "capture";
+    case target::post_r21_query:
+        return "post_r21_query";
+    }
+
+    return "unknown";
+}
+
+/* See header for documentation */
+usage run_target(
+    target tgt,
+    const uint8_t* data,
+    std::size_t size
+) {
+    using clock = std::chrono::steady_clock;
+
+    live_bytes = 0;
+    peak_bytes = 0;
+    tracking = true;
+
+    auto start = clock::now();
+    run_target_body(tgt, data, size);
+    auto elapsed = clock::now() - start;
+
+    tracking = false;
+
+    return {
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+        peak_bytes
+    };
+}
+
+/* See header for documentation */
+bool is_within_budget(
+    const usage& use,
+    std::size_t size
+) {
+    return (use.time_ns <= (time_ns_per_byte * size + time_ns_fixed)) &&
+           (use.peak_bytes <= (heap_bytes_per_byte * size + heap_bytes_fixed));
+}
+
+}
+}
+
+/* See header for documentation */
+extern "C" int LLVMFuzzerTestOneInput(
+    const uint8_t* data,
+    std::size_t size
+) {
+    using namespace libarmgpuinfo;
+
+    for (auto tgt : fuzz::all_targets) {
+        // Retry over-budget runs, so that a preempted run is not reported
+        auto use = fuzz::run_target(tgt, data, size);
+        for (int retry = 0; (retry < max_retries) && !fuzz::is_within_budget(use, size); retry++) {
+            auto next = fuzz::run_target(tgt, data, size);
+            use.time_ns = std::min(use.time_ns, next.time_ns);
+            use.peak_bytes = std::min(use.peak_bytes, next.peak_bytes);
+        }
+
+        if (!fuzz::is_within_budget(use, size)) {
+            std::fprintf(stderr, "ERROR: %s exceeded budget for %zu byte input: %llu ns, %zu heap bytes\n",
+                         fuzz::get_target_name(tgt), size,
+                         static_cast<unsigned long long>(use.time_ns), use.peak_bytes);
+            std::abort();
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Fuzz targets for the kernel driver property decoders.
+ *
+ * Each fuzz input is run through every target. Besides the memory errors
+ * detected by the sanitizers, each target is checked against a heap and run
+ * time budget that is linear in the input size, so that inputs that make
+ * decoding cost grow superlinearly are reported as failures.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace libarmgpuinfo {
+namespace fuzz {
+
+/** A fuzz target. */
+enum class target {
+    /** The post-r21 property buffer decoder. */
+    post_r21_decoder,
+    /** The pre-r21 property structure reader and decoder. */
+    pre_r21_decoder,
+    /** Capture parsing and decoding. */
+    capture,
+    /**
+     * A full post-r21 query, using a driver that reports the input as its
+     * property buffer. The first 4 bytes are the buffer size reported by the
+     * size query, and the next 4 bytes the size reported by the data query.
+     */
+    post_r21_query
+};
+
+/** All fuzz targets. */
+constexpr target all_targets[] {
+    target::post_r21_decoder,
+    target::pre_r21_decoder,
+    target::capture,
+    target::post_r21_query
+};
+
+/** Resource usage of a single target run. */
+struct usage {
+    /** The run time in nanoseconds. */
+    uint64_t time_ns;
+    /** The peak heap usage in bytes. */
+    std::size_t peak_bytes;
+};
+
+/** @return The name of a target. */
+const char* get_target_name(
+    target tgt);
+
+/**
+ * Run a target on an input, measuring its resource usage.
+ *
+ * @param tgt    The target.
+ * @param data   The input data.
+ * @param size   The input size in bytes.
+ *
+ * @return The resource usage.
+ */
+usage run_target(
+    target tgt,
+    const uint8_t* data,
+    std::size_t size);
+
+/**
+ * Check resource usage against the budget for an input size.
+ *
+ * @param use    The resource usage.
+ * @param size   The input size in bytes.
+ *
+ * @return @c true if the usage is within budget, @c false otherwise.
+ */
+bool is_within_budget(
+    const usage& use,
+    std::size_t size);
+
+}
+}
+
+/** libFuzzer entry point; runs every target and aborts if over budget. */
+extern "C" int LLVMFuzzerTestOneInput(
+    const uint8_t* data,
+    std::size_t size);
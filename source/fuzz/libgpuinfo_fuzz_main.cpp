@@ -0,0 +1,407 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Standalone driver for the libGPUInfo fuzz targets.
+ *
+ * Usage:
+ *
+ *     libgpuinfo_fuzz [--scaling] [--random <count>] [<file or directory> ...]
+ *
+ * This driver is used when the fuzz targets are not built with libFuzzer. It
+ * replays the given input files, runs a number of random mutations of the
+ * synthetic corpus, and with --scaling checks that the cost of each target
+ * grows no faster than linearly with input size.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "libgpuinfo_capture.hpp"
+#include "fake_driver/libgpuinfo_corpus.hpp"
+#include "fake_driver/libgpuinfo_fake_driver.hpp"
+#include "fuzz/libgpuinfo_fuzz.hpp"
+
+using namespace libarmgpuinfo;
+
+namespace {
+
+/**
+ * Input sizes compared by the scaling check. The small size is large enough
+ * that the branch predictor cannot learn a random input.
+ */
+constexpr std::size_t scaling_small_size { 64 * 1024 };
+constexpr std::size_t scaling_large_size { 1024 * 1024 };
+
+/**
+ * Number of measurements per scaling check input, each with a fresh input;
+ * the median time is compared.
+ */
+constexpr int scaling_runs { 5 };
+
+/** Maximum allowed growth in cost per input byte between the two sizes. */
+constexpr double max_growth_per_byte { 4.0 };
+
+/** Deterministic pseudo-random number generator. */
+class random_source {
+  public:
+    explicit random_source(uint64_t seed) : state_ { seed ? seed : 1 } {}
+
+    uint64_t next()
+    {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 7;
+        state_ ^= state_ << 17;
+        return state_;
+    }
+
+    std::size_t below(std::size_t limit)
+    {
+        return limit ? static_cast<std::size_t>(next() % limit) : 0;
+    }
+
+  private:
+    uint64_t state_;
+};
+
+using input = std::vector<uint8_t>;
+
+/** Run one input through the fuzz entry point. */
+void run_input(const input& data)
+{
+    LLVMFuzzerTestOneInput(data.data(), data.size());
+}
+
+/** Replay a file, or every file in a directory. */
+bool replay(const std::string& path, std::size_t& count)
+{
+    struct stat s {};
+    if (stat(path.c_str(), &s) != 0) {
+        std::cerr << "ERROR: Failed to open " << path << "\n";
+        return false;
+    }
+
+    if (S_ISDIR(s.st_mode)) {
+        DIR* dir = opendir(path.c_str());
+        if (!dir) {
+            std::cerr << "ERROR: Failed to open " << path << "\n";
+            return false;
+        }
+
+        std::vector<std::string> names;
+        while (dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] != '.') {
+                names.push_back(path + "/" + entry->d_name);
+            }
+        }
+        closedir(dir);
+
+        std::sort(names.begin(), names.end());
+        for (const auto& name : names) {
+            if (!replay(name, count)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    input data { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+    run_input(data);
+    count++;
+    return true;
+}
+
+/** @return Seed inputs derived from the synthetic corpus. */
+std::vector<input> make_seeds()
+{
+    std::vector<input> seeds;
+    for (const auto& test : fake::make_corpus()) {
+        const auto capture = fake::encode_capture(test.gpu);
+        seeds.emplace_back(capture.begin(), capture.end());
+
+        if (test.gpu.kernel == fake::kernel_type::post_r21_jm) {
+            const auto props = fake::encode_post_r21_props(test.gpu);
+            seeds.emplace_back(props.begin(), props.end());
+        }
+    }
+
+    return seeds;
+}
+
+/** Apply a random mutation to an input. */
+void mutate(input& data, random_source& rng)
+{
+    switch (rng.below(6)) {
+    case 0:
+        if (!data.empty()) {
+            data[rng.below(data.size())] ^= static_cast<uint8_t>(1U << rng.below(8));
+        }
+        break;
+    case 1:
+        if (!data.empty()) {
+            data[rng.below(data.size())] = rng.below(2) ? 0x00 : 0xFF;
+        }
+        break;
+    case 2:
+        data.resize(rng.below(data.size() + 1));
+        break;
+    case 3: {
+        std::size_t start = rng.below(data.size() + 1);
+        std::size_t length = rng.below(data.size() - start + 1);
+        input chunk(data.begin() + start, data.begin() + start + length);
+        data.insert(data.begin() + rng.below(data.size() + 1), chunk.begin(), chunk.end());
+        break;
+    }
+    case 4: {
+        std::size_t length = rng.below(16);
+        std::size_t pos = rng.below(data.size() + 1);
+        for (std::size_t i = 0; i < length; i++) {
+            data.insert(data.begin() + pos, static_cast<uint8_t>(rng.next()));
+        }
+        break;
+    }
+    default:
+        // Overwrite a 32-bit field, e.g. a property key or size
+        if (data.size() >= 4) {
+            std::size_t pos = rng.below(data.size() - 3);
+            detail::store_le<uint32_t>(data.data() + pos, static_cast<uint32_t>(rng.next()));
+        }
+        break;
+    }
+}
+
+/** Run random mutations of the seed inputs. */
+void run_random(std::size_t count)
+{
+    random_source rng { 0x6c69626770756966ULL };
+    const auto seeds = make_seeds();
+
+    for (std::size_t i = 0; i < count; i++) {
+        input data = seeds[rng.below(seeds.size())];
+        std::size_t num_mutations = 1 + rng.below(8);
+        for (std::size_t m = 0; m < num_mutations; m++) {
+            mutate(data, rng);
+        }
+
+        run_input(data);
+    }
+}
+
+/** Append a property key and value to a property buffer. */
+void append_prop(input& data, uint32_t code, uint32_t size_code, uint64_t value)
+{
+    uint8_t bytes[12];
+    detail::store_le<uint32_t>(bytes, (code << 2) | size_code);
+    detail::store_le<uint64_t>(bytes + 4, value);
+    data.insert(data.end(), bytes, bytes + 4 + (std::size_t { 1 } << size_code));
+}
+
+/** Make a property buffer of an input family, of at least the given size. */
+input make_family_input(const std::string& family, std::size_t size, uint64_t seed)
+{
+    input data;
+    random_source rng { size + seed };
+
+    if (family == "random") {
+        while (data.size() < size) {
+            data.push_back(static_cast<uint8_t>(rng.next()));
+        }
+    } else if (family == "props_u8") {
+        // The smallest possible properties, maximizing properties per byte
+        while (data.size() < size) {
+            append_prop(data, 200, 0, 0);
+        }
+    } else if (family == "props_u64") {
+        // Product ID properties, each requiring a catalog lookup
+        while (data.size() < size) {
+            append_prop(data, 1, 3, 0xa002);
+        }
+    } else {
+        // A realistic buffer from a driver reporting many unknown properties
+        auto gpu = fake::make_gpu(fake::kernel_type::post_r21_jm, 0xa002, 10);
+        const auto base = fake::encode_post_r21_props(gpu);
+        gpu.num_unknown_props = static_cast<uint32_t>((size > base.size()) ? ((size - base.size()) / 8 + 1) : 0);
+        const auto props = fake::encode_post_r21_props(gpu);
+        data.assign(props.begin(), props.end());
+    }
+
+    return data;
+}
+
+/** Wrap a property buffer into the input format of a target. */
+input make_target_input(fuzz::target tgt, const input& props)
+{
+    input data;
+
+    switch (tgt) {
+    case fuzz::target::capture:
+        data.resize(detail::capture_header_size);
+        detail::write_capture_header(detail::capture_kernel::post_r21_jm,
+                                     static_cast<uint32_t>(props.size()), data.data());
+        break;
+    case fuzz::target::post_r21_query:
+        data.resize(8);
+        detail::store_le<uint32_t>(data.data(), static_cast<uint32_t>(props.size()));
+        detail::store_le<uint32_t>(data.data() + 4, static_cast<uint32_t>(props.size()));
+        break;
+    default:
+        break;
+    }
+
+    data.insert(data.end(), props.begin(), props.end());
+    return data;
+}
+
+/**
+ * Measure the resource usage of a target over several runs, each with a fresh
+ * input of an input family.
+ *
+ * @param tgt          The target.
+ * @param family       The input family.
+ * @param size         The property buffer size.
+ * @param best         The returned best time and peak heap use, for the budget.
+ * @param median_ns    The returned median time, for the growth in cost.
+ * @param input_size   The returned target input size.
+ */
+void measure(
+    fuzz::target tgt,
+    const std::string& family,
+    std::size_t size,
+    fuzz::usage& best,
+    uint64_t& median_ns,
+    std::size_t& input_size
+) {
+    std::vector<uint64_t> times;
+    best = {};
+    input_size = 0;
+
+    for (int r = 0; r < scaling_runs; r++) {
+        const input data = make_target_input(tgt, make_family_input(family, size, r));
+        auto use = fuzz::run_target(tgt, data.data(), data.size());
+        if ((r == 0) || (use.time_ns < best.time_ns)) {
+            best.time_ns = use.time_ns;
+        }
+
+        best.peak_bytes = std::max(best.peak_bytes, use.peak_bytes);
+        input_size = std::max(input_size, data.size());
+        times.push_back(use.time_ns);
+    }
+
+    std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+    median_ns = times[times.size() / 2];
+}
+
+/** Check that every target scales linearly for every input family. */
+bool run_scaling()
+{
+    bool pass { true };
+
+    for (const char* family : { "random", "props_u8", "props_u64", "realistic" }) {
+        for (auto tgt : fuzz::all_targets) {
+            fuzz::usage small_use, large_use;
+            uint64_t small_median_ns, large_median_ns;
+            std::size_t small_size, large_size;
+            measure(tgt, family, scaling_small_size, small_use, small_median_ns, small_size);
+            measure(tgt, family, scaling_large_size, large_use, large_median_ns, large_size);
+
+            // Compare median cost per byte, with a floor to avoid timer resolution noise
+            const double small_ns = std::max<double>(static_cast<double>(small_median_ns), 1000.0) / small_size;
+            const double large_ns = static_cast<double>(large_median_ns) / large_size;
+            const double growth = large_ns / small_ns;
+
+            const bool ok = (growth <= max_growth_per_byte) &&
+                            fuzz::is_within_budget(small_use, small_size) &&
+                            fuzz::is_within_budget(large_use, large_size);
+            pass = pass && ok;
+
+            char line[200];
+            snprintf(line, sizeof(line), "  %-10s %-17s %9.3f ns/byte -> %9.3f ns/byte, heap %7zu -> %7zu bytes %s\n",
+                     family, fuzz::get_target_name(tgt), small_ns, large_ns,
+                     small_use.peak_bytes, large_use.peak_bytes, ok ? "ok" : "SUPERLINEAR");
+            std::cout << line;
+        }
+    }
+
+    return pass;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    bool scaling { false };
+    std::size_t random_count { 0 };
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg { argv[i] };
+        if (arg == "--scaling") {
+            scaling = true;
+        } else if ((arg == "--random") && (i + 1 < argc)) {
+            random_count = std::strtoul(argv[++i], nullptr, 0);
+        } else if ((arg.size() > 1) && (arg[0] == '-')) {
+            std::cerr << "Usage: libgpuinfo_fuzz [--scaling] [--random <count>] [<file or directory> ...]\n";
+            return EXIT_FAILURE;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+
+    std::size_t replayed { 0 };
+    for (const auto& path : paths) {
+        if (!replay(path, replayed)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (replayed) {
+        std::cout << "Replayed " << replayed << " inputs\n";
+    }
+
+    if (random_count) {
+        run_random(random_count);
+        std::cout << "Ran " << random_count << " random inputs\n";
+    }
+
+    if (scaling) {
+        std::cout << "Scaling check:\n";
+        if (!run_scaling()) {
+            std::cerr << "FAIL: Superlinear decode cost detected\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
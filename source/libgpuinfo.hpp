@@ -46,12 +46,22 @@
  *
  * Note that the returned information object is returned by reference, and has
  * the same lifetime as the instance object.
+ *
+ * The library can also be used in header-only mode, by defining the macro
+ * LIBGPUINFO_HEADER_ONLY before including this header. In this mode the whole
+ * implementation is inline, and the product catalog lookups are constexpr so
+ * the compiler can fold them when the product configuration is known at
+ * compile time:
+ *
+ *     constexpr gpuinfo info = libarmgpuinfo::get_product_info(0xa002, 10);
+ *     static_assert(info.num_fp32_fmas_per_cy == 64, "Unexpected FMA rate");
  */
 
 #pragma once
 
 #include <array>
 #include <cerrno>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 #include <string>
@@ -62,8 +72,216 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+/**
+ * Visibility attribute for public API symbols.
+ *
+ * The library is built with hidden visibility by default, so only symbols
+ * tagged with this attribute are exported from the shared library.
+ */
+#if !defined(LIBGPUINFO_API)
+    #if defined(LIBGPUINFO_HEADER_ONLY)
+        #define LIBGPUINFO_API
+    #else
+        #define LIBGPUINFO_API __attribute__((visibility("default")))
+    #endif
+#endif
+
+/**
+ * Linkage specifiers for functions defined in the implementation.
+ *
+ * In header-only mode functions are defined inline, and functions that can be
+ * evaluated at compile time are constexpr.
+ */
+#if defined(LIBGPUINFO_HEADER_ONLY)
+    #define LIBGPUINFO_INLINE inline
+    #define LIBGPUINFO_CONSTEXPR constexpr
+#else
+    #define LIBGPUINFO_INLINE
+    #define LIBGPUINFO_CONSTEXPR
+#endif
+
 namespace libarmgpuinfo {
 
+/** Maximum number of core groups that can be reported. */
+constexpr uint32_t max_core_groups { 16 };
+
+/**
+ * A group of shader cores that share a coherent view of memory.
+ *
+ * Most GPUs have a single core group. Some older Midgard GPUs, and some
+ * safety configurations, split the shader cores into multiple groups that
+ * each have their own L2 cache.
+ */
+struct core_group
+{
+    /** Shader core topology mask of the group */
+    uint64_t core_mask;
+
+    /** Number of shader cores in the group */
+    uint32_t num_cores;
+
+    /** Index of the L2 cache used by the group */
+    uint32_t l2_index;
+};
+
+/** Shader core topology. */
+struct core_topology
+{
+    /** Number of valid entries in the groups array */
+    uint32_t num_groups;
+
+    /** Number of L2 caches, each of which may have multiple slices */
+    uint32_t num_l2_caches;
+
+    /** Core groups */
+    core_group groups[max_core_groups];
+};
+
+/** Number of TEXTURE_FEATURES registers. */
+constexpr uint32_t num_texture_features_registers { 4 };
+
+/**
+ * Compressed texture format families.
+ *
+ * The values are bit indices in gpuinfo::texture_formats. A family is only
+ * reported as supported if the GPU supports every format in the family.
+ */
+enum class texture_format : uint32_t {
+    /** ETC2 RGB8, RGBA8, and RGB8 with punch-through alpha */
+    etc2 = 0,
+    /** EAC R11 and RG11, unsigned and signed */
+    eac = 1,
+    /** ASTC 2D blocks, LDR profile */
+    astc_ldr = 2,
+    /** ASTC 2D blocks, HDR profile */
+    astc_hdr = 3,
+    /** ASTC 3D blocks, LDR profile */
+    astc_3d_ldr = 4,
+    /** ASTC 3D blocks, HDR profile */
+    astc_3d_hdr = 5,
+    /** BC1, also known as DXT1 */
+    bc1 = 6,
+    /** BC2, also known as DXT3 */
+    bc2 = 7,
+    /** BC3, also known as DXT5 */
+    bc3 = 8,
+    /** BC4, unsigned and signed */
+    bc4 = 9,
+    /** BC5, unsigned and signed */
+    bc5 = 10,
+    /** BC6H, unsigned and signed float */
+    bc6h = 11,
+    /** BC7 */
+    bc7 = 12
+};
+
+/** Class of texture content, used to rank compressed formats. */
+enum class texture_content {
+    /** Opaque color */
+    color_rgb,
+    /** Color with alpha */
+    color_rgba,
+    /** Two-channel data, such as tangent space normal maps */
+    normal_map,
+    /** Single-channel data, such as masks or height maps */
+    single_channel,
+    /** High dynamic range color */
+    hdr_color,
+    /** Low dynamic range volume textures */
+    volume
+};
+
+/** Maximum number of formats in a texture format ranking. */
+constexpr uint32_t max_ranked_texture_formats { 4 };
+
+/** Supported compressed texture formats for a content class, fastest first. */
+struct texture_format_ranking
+{
+    /** Number of valid entries in the formats array */
+    uint32_t num_formats;
+
+    /** Supported formats, fastest first */
+    texture_format formats[max_ranked_texture_formats];
+};
+
+/** Memory coherency protocol between the GPU and the CPU. */
+enum class coherency_protocol : uint32_t {
+    /** Not coherent, so software cache maintenance is required */
+    none = 0,
+    /** ACE-Lite, so GPU accesses snoop the CPU caches */
+    ace_lite = 1,
+    /** ACE, so GPU and CPU accesses snoop each other's caches */
+    ace = 2
+};
+
+/** GPU work scheduling interface. */
+enum class scheduler_type : uint32_t {
+    /** Unknown scheduling interface */
+    unknown = 0,
+    /** Job Manager GPU, with hardware job slots */
+    job_manager = 1,
+    /** Command Stream Frontend GPU, with firmware-scheduled queue groups */
+    csf = 2
+};
+
+/** Maximum number of hardware job slots. */
+constexpr uint32_t max_job_slots { 16 };
+
+/**
+ * Work submission capabilities.
+ *
+ * Job Manager GPUs report job slots; work submitted to different slots can
+ * run concurrently. CSF GPUs report queue groups; each group occupies a
+ * firmware scheduling slot, and the queues in a group run concurrently.
+ */
+struct queue_info
+{
+    /** GPU work scheduling interface */
+    scheduler_type scheduler;
+
+    /** Number of hardware job slots */
+    uint32_t num_job_slots;
+
+    /** Raw JS_FEATURES register value of each job slot, indexed by slot */
+    uint32_t job_slot_features[max_job_slots];
+
+    /** Number of job slots that accept compute jobs */
+    uint32_t num_compute_slots;
+
+    /** Number of job slots that accept fragment jobs */
+    uint32_t num_fragment_slots;
+
+    /** CSF firmware global interface version */
+    uint32_t csf_interface_version;
+
+    /** Number of CSF queue groups that can be resident at the same time */
+    uint32_t num_queue_groups;
+
+    /** Number of queues in each CSF queue group, the minimum over all groups */
+    uint32_t num_queues_per_group;
+};
+
+/**
+ * Tiler configuration.
+ *
+ * The tiler bins each primitive into the screen tiles that it covers, writing
+ * a polygon list to a heap that grows in bins of bin_size_bytes.
+ */
+struct tiler_info
+{
+    /** Raw TILER_FEATURES register value, or zero if unknown */
+    uint32_t tiler_features;
+
+    /** Tiler heap bin size, in bytes */
+    uint32_t bin_size_bytes;
+
+    /** Maximum number of active hierarchy levels */
+    uint32_t max_active_levels;
+
+    /** Maximum number of primitives per clock, for the whole GPU */
+    uint32_t num_prims_per_cy;
+};
+
 /** Arm GPU information. */
 struct gpuinfo
 {
@@ -111,8 +329,718 @@ struct gpuinfo
 
     /** Maximum number of output pixels per clock per core */
     uint32_t num_pixels_per_cy;
+
+    /** Shader core topology, with the cores in shader_core_mask */
+    core_topology topology;
+
+    /** L2 cache size of each slice, in bytes */
+    uint32_t num_l2_slice_bytes;
+
+    /** L2 cache line size, in bytes */
+    uint32_t num_l2_line_bytes;
+
+    /** Raw TEXTURE_FEATURES register values, or zero if unknown */
+    uint32_t texture_features[num_texture_features_registers];
+
+    /** Supported compressed texture formats, as texture_format bits */
+    uint32_t texture_formats;
+
+    /** Coherency protocol selected by the kernel driver */
+    coherency_protocol coherency;
+
+    /** Coherency protocols supported by the GPU, as coherency_protocol bits */
+    uint32_t coherency_protocols;
+
+    /** Maximum memory available to the GPU, in bytes */
+    uint64_t num_gpu_memory_bytes;
+
+    /** Number of GPU virtual address bits */
+    uint32_t num_va_bits;
+
+    /** Number of GPU physical address bits */
+    uint32_t num_pa_bits;
+
+    /** Number of MMU address spaces */
+    uint32_t num_address_spaces;
+
+    /** Work submission capabilities */
+    queue_info queues;
+
+    /** Tiler configuration */
+    tiler_info tiler;
+
+    /** Maximum number of resident threads per core */
+    uint32_t num_threads_per_core;
+
+    /** Register file size per core, in 32-bit registers, or zero if unknown */
+    uint32_t num_registers_per_core;
+
+    /** Maximum number of int8 dot product MACs per clock per core, or zero if unsupported */
+    uint32_t num_int8_macs_per_cy;
+
+    /** Maximum number of fp16 dot product MACs per clock per core */
+    uint32_t num_fp16_macs_per_cy;
 };
 
+/** A contiguous range of shader core indices. */
+struct core_range
+{
+    /** Index of the first core in the range */
+    uint32_t first;
+
+    /** Number of cores in the range */
+    uint32_t count;
+};
+
+/**
+ * Make a single group core topology for a shader core mask.
+ *
+ * @param core_mask   The shader core topology mask.
+ *
+ * @return The core topology.
+ */
+constexpr core_topology make_core_topology(
+    uint64_t core_mask
+) {
+    core_topology topology {};
+    topology.num_groups = 1;
+    topology.num_l2_caches = 1;
+    topology.groups[0].core_mask = core_mask;
+    topology.groups[0].num_cores = __builtin_popcountll(core_mask);
+    return topology;
+}
+
+/**
+ * Call a function for each shader core in a core mask, in index order.
+ *
+ * Core masks may be sparse, so core indices are not always contiguous.
+ *
+ * @param core_mask   The shader core topology mask.
+ * @param fn          The function to call, taking the uint32_t core index.
+ */
+template <typename F>
+inline void for_each_core(
+    uint64_t core_mask,
+    F fn
+) {
+    while (core_mask) {
+        fn(static_cast<uint32_t>(__builtin_ctzll(core_mask)));
+        core_mask &= core_mask - 1;
+    }
+}
+
+/**
+ * Call a function for each contiguous range of shader cores in a core mask,
+ * in index order.
+ *
+ * @param core_mask   The shader core topology mask.
+ * @param fn          The function to call, taking the core_range.
+ */
+template <typename F>
+inline void for_each_core_range(
+    uint64_t core_mask,
+    F fn
+) {
+    while (core_mask) {
+        const uint32_t first = __builtin_ctzll(core_mask);
+        const uint64_t shifted = ~(core_mask >> first);
+        const uint32_t count = shifted ? __builtin_ctzll(shifted) : (64 - first);
+        fn(core_range { first, count });
+
+        core_mask = (first + count < 64) ? (core_mask & (~0ULL << (first + count))) : 0;
+    }
+}
+
+/**
+ * Get the GPU information for a known product configuration.
+ *
+ * This performs the same product catalog lookup as a device query, but
+ * without connecting to the kernel driver. Only the information that can be
+ * derived from the product configuration is populated; the shader core mask
+ * is assumed to be contiguous in a single core group, and the memory system
+ * information is zero.
+ *
+ * In header-only mode this function is constexpr.
+ *
+ * @param product_id         The GPU product ID, e.g. 0xa002.
+ * @param num_shader_cores   The number of shader cores.
+ * @param core_features      The raw CORE_FEATURES register value.
+ * @param thread_features    The raw THREAD_FEATURES register value.
+ *
+ * @return The GPU information.
+ */
+LIBGPUINFO_API LIBGPUINFO_CONSTEXPR gpuinfo get_product_info(
+    uint32_t product_id,
+    uint32_t num_shader_cores,
+    uint32_t core_features=0,
+    uint32_t thread_features=0);
+
+/**
+ * Decode the GPU information from a kernel driver property capture.
+ *
+ * A capture stores the raw property data returned by a kernel driver, so that
+ * devices can be analyzed offline. Captures are untrusted input; malformed or
+ * truncated captures are rejected. See libgpuinfo_capture.hpp for the format.
+ *
+ * @param data   The capture data.
+ * @param size   The capture size in bytes.
+ * @param info   The returned GPU information.
+ *
+ * @return @c true if the capture was decoded, @c false otherwise.
+ */
+LIBGPUINFO_API bool decode_capture(
+    const void* data,
+    std::size_t size,
+    gpuinfo& info);
+
+/**
+ * Product configurations for a batch catalog lookup, as struct-of-arrays
+ * columns that each hold one value per configuration.
+ */
+struct product_config_columns
+{
+    /** GPU product IDs, e.g. 0xa002 */
+    const uint32_t* product_ids;
+
+    /** Numbers of shader cores */
+    const uint32_t* num_shader_cores;
+
+    /** Raw CORE_FEATURES register values, or @c nullptr if all zero */
+    const uint32_t* core_features;
+
+    /** Raw THREAD_FEATURES register values, or @c nullptr if all zero */
+    const uint32_t* thread_features;
+};
+
+/**
+ * Caller-provided struct-of-arrays result columns for batch queries.
+ *
+ * Each column that is not @c nullptr must have space for one value per
+ * batch entry, and holds the gpuinfo field of the same name. Columns that
+ * are @c nullptr are not written, so a batch only pays for the results that
+ * the caller uses.
+ */
+struct gpuinfo_columns
+{
+    uint32_t* gpu_id;
+    const char** gpu_name;
+    const char** architecture_name;
+    uint32_t* architecture_major;
+    uint32_t* architecture_minor;
+    uint32_t* num_shader_cores;
+    uint64_t* shader_core_mask;
+    uint32_t* num_l2_slices;
+    uint32_t* num_l2_bytes;
+    uint32_t* num_bus_bits;
+    uint32_t* num_exec_engines;
+    uint32_t* num_fp32_fmas_per_cy;
+    uint32_t* num_fp16_fmas_per_cy;
+    uint32_t* num_int8_macs_per_cy;
+    uint32_t* num_fp16_macs_per_cy;
+    uint32_t* num_texels_per_cy;
+    uint32_t* num_pixels_per_cy;
+    uint32_t* num_tiler_prims_per_cy;
+    uint32_t* num_threads_per_core;
+};
+
+/**
+ * Get the GPU information for a batch of known product configurations.
+ *
+ * Each result is the same as get_product_info() for the configuration.
+ * Configurations are resolved against the catalog a tile at a time, and the
+ * catalog values are then gathered into the result columns with simple loops
+ * that the compiler can vectorize. Only products whose rates depend on the
+ * core configuration, such as Mali-G510, take a per-configuration path.
+ *
+ * @param configs   The product configurations.
+ * @param count     The number of configurations.
+ * @param results   The result columns.
+ */
+LIBGPUINFO_API void get_product_info_batch(
+    const product_config_columns& configs,
+    std::size_t count,
+    const gpuinfo_columns& results);
+
+/**
+ * Decode the GPU information from a batch of kernel driver property captures.
+ *
+ * Each result is the same as decode_capture() for the capture. Results for
+ * captures that cannot be decoded are zero, with @c nullptr names.
+ *
+ * @param captures   The capture data of each capture.
+ * @param sizes      The size of each capture in bytes.
+ * @param count      The number of captures.
+ * @param results    The result columns.
+ * @param decoded    The returned decode status of each capture, or @c nullptr.
+ *
+ * @return The number of captures that were decoded.
+ */
+LIBGPUINFO_API std::size_t decode_capture_batch(
+    const void* const* captures,
+    const std::size_t* sizes,
+    std::size_t count,
+    const gpuinfo_columns& results,
+    bool* decoded);
+
+/** Working set description of a tiled image-processing pass. */
+struct l2_working_set
+{
+    /** Width of the tile processed by each workgroup, in texels */
+    uint32_t tile_width;
+
+    /** Height of the tile processed by each workgroup, in texels */
+    uint32_t tile_height;
+
+    /** Bytes accessed per texel, summed over all input and output images */
+    uint32_t bytes_per_texel;
+
+    /** Number of shader cores processing tiles concurrently, or zero for all */
+    uint32_t num_concurrent_cores;
+};
+
+/** Recommended cache blocking for a working set. */
+struct l2_blocking
+{
+    /** Number of tiles per block horizontally */
+    uint32_t tiles_x;
+
+    /** Number of tiles per block vertically */
+    uint32_t tiles_y;
+
+    /** L2 footprint of one block, in bytes, with rows rounded to cache lines */
+    uint32_t block_bytes;
+
+    /** Edge length of a square texture atlas page, in texels */
+    uint32_t atlas_page_texels;
+};
+
+/**
+ * Recommend cache blocking factors for a tiled image-processing pass.
+ *
+ * Blocks are groups of tiles processed in sequence by one shader core. The
+ * recommended block is the largest that keeps one block per concurrent core
+ * within half of the total L2 cache size, leaving the remainder for other
+ * traffic. Block rows are rounded up to whole cache lines. The atlas page is
+ * the largest power-of-two square page that fits the same shared budget, so
+ * that pages sampled by all cores stay resident.
+ *
+ * All factors are zero if the L2 cache geometry is unknown, or if a single
+ * tile does not fit in the budget.
+ *
+ * In header-only mode this function is constexpr.
+ *
+ * @param info          The GPU information.
+ * @param working_set   The working set description.
+ *
+ * @return The recommended blocking.
+ */
+LIBGPUINFO_API LIBGPUINFO_CONSTEXPR l2_blocking get_l2_blocking(
+    const gpuinfo& info,
+    const l2_working_set& working_set);
+
+/**
+ * Test if the GPU is IO coherent with the CPU.
+ *
+ * When the GPU is IO coherent, GPU reads observe CPU writes without a CPU
+ * cache clean, so buffers that the CPU writes for the GPU to read can use
+ * cached CPU mappings without explicit cache maintenance. GPU writes are only
+ * observed by CPU reads without a cache invalidate if the protocol is ACE.
+ *
+ * The result is @c false if the coherency is unknown, for example for
+ * information returned by get_product_info().
+ *
+ * @param info   The GPU information.
+ *
+ * @return @c true if the GPU is IO coherent with the CPU.
+ */
+constexpr bool is_io_coherent(
+    const gpuinfo& info
+) {
+    return info.coherency != coherency_protocol::none;
+}
+
+/**
+ * Test if a compressed texture format family is supported.
+ *
+ * @param info     The GPU information.
+ * @param format   The texture format family.
+ *
+ * @return @c true if the format family is supported.
+ */
+constexpr bool has_texture_format(
+    const gpuinfo& info,
+    texture_format format
+) {
+    return (info.texture_formats >> static_cast<uint32_t>(format)) & 1;
+}
+
+/**
+ * Rank the supported compressed texture formats for a content class.
+ *
+ * Formats are ranked by sampling cost, which for compressed formats that
+ * filter at full rate is dominated by memory bandwidth. Formats with a lower
+ * bit rate at acceptable quality for the content class rank first, so ASTC is
+ * preferred where it is supported. Formats that the GPU does not support are
+ * omitted, so the ranking is empty if the texture features are unknown, for
+ * example for information returned by get_product_info().
+ *
+ * In header-only mode this function is constexpr.
+ *
+ * @param info      The GPU information.
+ * @param content   The texture content class.
+ *
+ * @return The supported formats, fastest first.
+ */
+LIBGPUINFO_API LIBGPUINFO_CONSTEXPR texture_format_ranking get_texture_format_ranking(
+    const gpuinfo& info,
+    texture_content content);
+
+/** Recommended sizing for a large GPU memory pool. */
+struct memory_pool_sizing
+{
+    /** Pool size, in bytes, rounded to whole chunks */
+    uint64_t pool_bytes;
+
+    /** Pool allocation chunk size, in bytes */
+    uint64_t chunk_bytes;
+
+    /** Number of chunks in the pool */
+    uint64_t num_chunks;
+
+    /** Page size for sparse allocations, in bytes */
+    uint64_t sparse_page_bytes;
+
+    /** Maximum virtual address range to reserve for sparse allocations, in bytes */
+    uint64_t max_sparse_bytes;
+};
+
+/**
+ * Recommend the sizing of a large GPU memory pool.
+ *
+ * The pool is limited to half of the memory available to the GPU, leaving the
+ * remainder for the rest of the system, and is allocated in 2MB chunks so that
+ * the kernel driver can map it using large MMU pages. Small pools use 64KB
+ * chunks. Sparse allocations use 64KB pages, and the sparse virtual address
+ * reservation is limited to a quarter of the GPU virtual address space.
+ *
+ * All sizes are zero if the GPU memory size or the virtual address size is
+ * unknown, for example for information returned by get_product_info().
+ *
+ * In header-only mode this function is constexpr.
+ *
+ * @param info              The GPU information.
+ * @param requested_bytes   The requested pool size, in bytes.
+ *
+ * @return The recommended sizing.
+ */
+LIBGPUINFO_API LIBGPUINFO_CONSTEXPR memory_pool_sizing get_memory_pool_sizing(
+    const gpuinfo& info,
+    uint64_t requested_bytes);
+
+/** Estimated tiler cost of a geometry workload. */
+struct tiler_cost
+{
+    /** Polygon list memory, in bytes, rounded to whole heap bins */
+    uint64_t polygon_list_bytes;
+
+    /** Transformed position and varying memory, in bytes */
+    uint64_t vertex_bytes;
+
+    /** Total tiler memory, in bytes */
+    uint64_t total_bytes;
+
+    /** Minimum tiler time, in GPU clock cycles */
+    uint64_t num_cycles;
+};
+
+/**
+ * Estimate the tiler memory and time cost of a geometry workload.
+ *
+ * The estimate assumes indexed meshes that shade one unique vertex per
+ * primitive, each with a 16 byte position and the given varyings, and an 8
+ * byte polygon list entry per primitive. The polygon list is rounded up to
+ * whole heap bins, with at least one bin per active hierarchy level. The time
+ * is the primitive count divided by the peak tiler rate, so is a lower bound
+ * that ignores vertex shading.
+ *
+ * The cycle count is zero if the tiler rate is unknown, and the polygon list
+ * is not rounded if the bin size is unknown, for example for information
+ * returned by get_product_info().
+ *
+ * In header-only mode this function is constexpr.
+ *
+ * @param info                  The GPU information.
+ * @param num_primitives        The number of primitives.
+ * @param num_varying_bytes     The varying size per vertex, in bytes.
+ *
+ * @return The estimated cost.
+ */
+LIBGPUINFO_API LIBGPUINFO_CONSTEXPR tiler_cost get_tiler_cost(
+    const gpuinfo& info,
+    uint64_t num_primitives,
+    uint32_t num_varying_bytes);
+
+/** Shader resource usage, as reported by the shader compiler. */
+struct shader_resources
+{
+    /** Work registers per thread, in the architecture register size */
+    uint32_t num_work_registers;
+
+    /** Uniform registers, or zero if unknown */
+    uint32_t num_uniform_registers;
+
+    /** Stack size per thread, in bytes, or zero if unknown */
+    uint32_t num_stack_bytes;
+};
+
+/** Shader core occupancy of a shader. */
+struct shader_occupancy
+{
+    /** Maximum resident threads per core, or zero if the shader does not fit */
+    uint32_t num_threads;
+
+    /** Resident threads, as a percentage of the maximum */
+    uint32_t occupancy_percent;
+
+    /**
+     * Largest work register count with the same occupancy. Using more work
+     * registers reaches the next occupancy cliff, unless this is the maximum
+     * work register count.
+     */
+    uint32_t num_cliff_registers;
+
+    /** Uniform registers that do not fit the uniform register file */
+    uint32_t num_spilled_uniform_registers;
+
+    /** Stack memory for the resident threads of a core, in bytes */
+    uint64_t num_stack_bytes_per_core;
+};
+
+/**
+ * Calculate the shader core occupancy of a shader.
+ *
+ * Threads allocate work registers in steps that double from the full
+ * occupancy register count of the architecture: 4 128-bit registers for
+ * Midgard, and 32 32-bit registers for later architectures. Each step halves
+ * the number of resident threads, which is also limited by the register file
+ * size if the kernel driver reports it. The calculation is a small table
+ * lookup, so is cheap enough to run for every shader variant.
+ *
+ * The result is zero if the architecture or thread count is unknown, or if
+ * the shader uses more work registers than the architecture supports.
+ *
+ * In header-only mode this function is constexpr.
+ *
+ * @param info        The GPU information.
+ * @param resources   The shader resource usage.
+ *
+ * @return The shader occupancy.
+ */
+LIBGPUINFO_API LIBGPUINFO_CONSTEXPR shader_occupancy get_shader_occupancy(
+    const gpuinfo& info,
+    const shader_resources& resources);
+
+/** Per-frame GPU workload summary. */
+struct frame_workload
+{
+    /** Number of 32-bit floating-point FMAs */
+    uint64_t num_fp32_fmas;
+
+    /** Number of 16-bit floating-point FMAs */
+    uint64_t num_fp16_fmas;
+
+    /** Number of bilinear filtered texels */
+    uint64_t num_texels;
+
+    /** Number of shaded output pixels */
+    uint64_t num_pixels;
+
+    /** Number of bytes read from external memory */
+    uint64_t num_read_bytes;
+
+    /** Number of bytes written to external memory */
+    uint64_t num_write_bytes;
+
+    /** Number of primitives */
+    uint64_t num_primitives;
+};
+
+/** GPU units that can limit the frame time. */
+enum class frame_unit : uint32_t {
+    /** No unit, because the workload is empty or no rates are known */
+    none,
+    /** Arithmetic, for fp32 and fp16 FMAs sharing the FMA pipelines */
+    arithmetic,
+    /** Texture filtering */
+    texture,
+    /** Pixel output */
+    pixel,
+    /** External memory bus */
+    memory,
+    /** Tiler */
+    tiler
+};
+
+/** Number of frame_unit values, including frame_unit::none. */
+constexpr uint32_t num_frame_units { 6 };
+
+/** Lower bounds of the frame time for each GPU unit. */
+struct frame_bounds
+{
+    /** Minimum time of each unit, in GPU clock cycles, indexed by frame_unit */
+    uint64_t num_cycles[num_frame_units];
+
+    /** Minimum time of each unit, in nanoseconds, indexed by frame_unit */
+    uint64_t num_ns[num_frame_units];
+
+    /** The unit with the longest minimum time */
+    frame_unit limiter;
+};
+
+/**
+ * Calculate the lower bounds of the frame time of a workload.
+ *
+ * Each unit is assumed to run at its peak rate on every shader core, in
+ * parallel with the other units, so the frame time cannot be shorter than the
+ * time of the limiting unit. FP32 and FP16 FMAs share the FMA pipelines, so
+ * their times are summed. External memory is assumed to transfer one bus
+ * width per cache slice per GPU clock.
+ *
+ * Units with unknown rates have zero time, and are never the limiter, so the
+ * memory bound is zero for information returned by get_product_info(). The
+ * calculation is a few integer divisions, so is cheap enough to run every
+ * frame.
+ *
+ * In header-only mode this function is constexpr.
+ *
+ * @param info       The GPU information.
+ * @param workload   The frame workload.
+ * @param clock_hz   The GPU clock frequency, in Hz.
+ *
+ * @return The frame time lower bounds.
+ */
+LIBGPUINFO_API LIBGPUINFO_CONSTEXPR frame_bounds get_frame_bounds(
+    const gpuinfo& info,
+    const frame_workload& workload,
+    uint64_t clock_hz);
+
+/** Data type of a machine learning operator. */
+enum class ml_data_type {
+    /** 8-bit integer inputs, weights, and outputs */
+    int8,
+    /** 16-bit floating-point inputs, weights, and outputs */
+    fp16
+};
+
+/** Shape of a matrix multiplication, C[m][n] = A[m][k] * B[k][n]. */
+struct gemm_shape
+{
+    /** Number of rows of A and C */
+    uint64_t m;
+
+    /** Number of columns of B and C */
+    uint64_t n;
+
+    /** Number of columns of A and rows of B */
+    uint64_t k;
+};
+
+/** Shape of a 2D convolution. */
+struct conv_shape
+{
+    /** Number of images in the batch */
+    uint64_t batch;
+
+    /** Output height, in elements */
+    uint64_t out_height;
+
+    /** Output width, in elements */
+    uint64_t out_width;
+
+    /** Number of input channels */
+    uint64_t in_channels;
+
+    /** Number of output channels */
+    uint64_t out_channels;
+
+    /** Kernel height, in elements */
+    uint64_t kernel_height;
+
+    /** Kernel width, in elements */
+    uint64_t kernel_width;
+
+    /** Stride in both dimensions, or zero for one */
+    uint64_t stride;
+};
+
+/** Estimated throughput of a machine learning operator. */
+struct ml_estimate
+{
+    /** Number of multiply-accumulates */
+    uint64_t num_macs;
+
+    /** Minimum external memory traffic, in bytes */
+    uint64_t num_bytes;
+
+    /** Minimum time of the dot product pipelines, in GPU clock cycles */
+    uint64_t num_compute_cycles;
+
+    /** Minimum time of the external memory bus, in GPU clock cycles */
+    uint64_t num_memory_cycles;
+
+    /** Minimum time of the operator, in GPU clock cycles */
+    uint64_t num_cycles;
+
+    /** Multiply-accumulates per clock, for the whole GPU */
+    uint64_t num_macs_per_cy;
+};
+
+/**
+ * Estimate the throughput of a matrix multiplication.
+ *
+ * The compute time assumes that every shader core runs the dot product
+ * pipelines at their peak rate for the data type. The memory time assumes
+ * that each input and output matrix is transferred once, at one bus width per
+ * L2 slice per GPU clock. The operator time is the longer of the two, so is a
+ * lower bound.
+ *
+ * All cycle counts and the throughput are zero if the GPU does not support
+ * dot products for the data type, or if the rates are unknown. The memory
+ * time is zero for information returned by get_product_info().
+ *
+ * In header-only mode this function is constexpr.
+ *
+ * @param info    The GPU information.
+ * @param shape   The matrix shape.
+ * @param type    The data type.
+ *
+ * @return The estimated throughput.
+ */
+LIBGPUINFO_API LIBGPUINFO_CONSTEXPR ml_estimate get_gemm_estimate(
+    const gpuinfo& info,
+    const gemm_shape& shape,
+    ml_data_type type);
+
+/**
+ * Estimate the throughput of a 2D convolution.
+ *
+ * The convolution is modelled as an implicit matrix multiplication, with the
+ * same assumptions as get_gemm_estimate(). The input size is derived from the
+ * output size and stride, assuming same padding, and each input, weight, and
+ * output element is transferred once.
+ *
+ * In header-only mode this function is constexpr.
+ *
+ * @param info    The GPU information.
+ * @param shape   The convolution shape.
+ * @param type    The data type.
+ *
+ * @return The estimated throughput.
+ */
+LIBGPUINFO_API LIBGPUINFO_CONSTEXPR ml_estimate get_conv_estimate(
+    const gpuinfo& info,
+    const conv_shape& shape,
+    ml_data_type type);
 
 /** Kbase ioctl interface type. */
 enum class iface_type {
@@ -122,10 +1050,43 @@ enum class iface_type {
     post_r21
 };
 
+/**
+ * Kernel driver system call interface.
+ *
+ * The default interface calls the operating system directly. An alternative
+ * interface can be provided to connect to the kernel driver indirectly, for
+ * example via a proxy, or to a fake driver for testing and benchmarking.
+ */
+struct driver_interface
+{
+    /** Open a device node, with the same semantics as open(). */
+    int (*open)(const char* path, int flags);
+
+    /** Close a device node, with the same semantics as close(). */
+    int (*close)(int fd);
+
+    /** Get device node status, with the same semantics as fstat(). */
+    int (*fstat)(int fd, struct stat* buf);
+
+    /** Issue a device request, with the same semantics as ioctl(). */
+    int (*ioctl)(int fd, unsigned long request, void* arg);
+
+    /**
+     * Get the kernel memory used by all contexts of a driver instance, in
+     * bytes, or a negative value if unknown. This is optional, and may be
+     * @c nullptr.
+     */
+    int64_t (*memory_usage)(uint32_t id);
+};
+
 /**
  * Mali device driver instance.
+ *
+ * The kernel driver connection is only held while the properties are queried,
+ * and is closed before create() returns. This releases the kernel driver
+ * context, so an idle instance uses no kernel memory.
  */
-class instance
+class LIBGPUINFO_API instance
 {
 public:
     /**
@@ -137,6 +1098,18 @@ public:
      */
     static std::unique_ptr<instance> create(const uint32_t id=0);
 
+    /**
+     * Factory function to create a device instance using a custom driver.
+     *
+     * @param id       The driver instance, e.g. 0 for /dev/mali0.
+     * @param driver   The kernel driver system call interface.
+     *
+     * @return The created instance, or @c nullptr on failure.
+     */
+    static std::unique_ptr<instance> create(
+        const uint32_t id,
+        const driver_interface& driver);
+
     /**
      * Get the GPU device property information.
      *
@@ -146,6 +1119,18 @@ public:
      */
     const gpuinfo& get_info() const;
 
+    /**
+     * Get the kernel memory released by closing the kernel driver connection
+     * after the query.
+     *
+     * The memory is measured from the kernel driver memory accounting, which
+     * for the system driver is the kbase debugfs gpu_memory file. This is
+     * normally only readable by privileged processes.
+     *
+     * @return The released memory in bytes, or zero if unknown.
+     */
+    uint64_t get_released_kernel_bytes() const;
+
     /**
      * Destroy an instance.
      *
@@ -157,37 +1142,23 @@ private:
     /**
      * Create a new instance.
      *
-     * @param fd   The opened driver file descriptor.
-     *
+     * @param driver   The kernel driver system call interface.
+     * @param fd       The opened driver file descriptor, which is not retained.
      */
-    instance(int fd);
-
-    /** Check the Mali kernel driver interface version. */
-    bool check_version();
-
-    /** Configure Mali kernel driver connection flags. */
-    bool set_flags();
-
-    /** Query properties and store them locally. */
-    bool init_props();
-
-    /** Get device constants from the old format ioctl. */
-    bool init_props_pre_r21();
-
-    /** Get device constants from the new format ioctl. */
-    bool init_props_post_r21();
+    instance(const driver_interface& driver, int fd);
 
     /** The queries device properties. */
     gpuinfo info_ {};
 
-    /** The driver interface type. */
-    iface_type iface_ {};
-
     /** The validity state of the object if initialization fails. */
     bool valid_ { true };
 
-    /** The kernel driver file descriptor. */
-    int fd_ {};
+    /** The kernel memory released by closing the connection, in bytes. */
+    uint64_t released_kernel_bytes_ {};
 };
 
 }
+
+#if defined(LIBGPUINFO_HEADER_ONLY)
+    #include "libgpuinfo_impl.hpp"
+#endif
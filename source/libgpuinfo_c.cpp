@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief The libGPUInfo C interface implementation.
+ */
+
+#include <cstring>
+
+#include "libgpuinfo_c.h"
+#include "libgpuinfo_device.hpp"
+
+namespace {
+
+using libarmgpuinfo::gpuinfo;
+using libarmgpuinfo::detail::query_status;
+
+static_assert(LIBARMGPUINFO_MAX_CORE_GROUPS == libarmgpuinfo::max_core_groups,
+              "C core group count must match the C++ interface");
+static_assert(LIBARMGPUINFO_NUM_TEXTURE_FEATURES_REGISTERS == libarmgpuinfo::num_texture_features_registers,
+              "C texture features register count must match the C++ interface");
+static_assert(LIBARMGPUINFO_MAX_JOB_SLOTS == libarmgpuinfo::max_job_slots,
+              "C job slot count must match the C++ interface");
+
+/** Convert an internal query status into a C result code. */
+libarmgpuinfo_result to_result(
+    query_status status
+) {
+    switch (status) {
+    case query_status::success:
+        return LIBARMGPUINFO_SUCCESS;
+    case query_status::open_failed:
+        return LIBARMGPUINFO_ERROR_DEVICE_NOT_FOUND;
+    case query_status::not_a_device:
+        return LIBARMGPUINFO_ERROR_NOT_A_DEVICE;
+    case query_status::unsupported_version:
+        return LIBARMGPUINFO_ERROR_UNSUPPORTED_DRIVER;
+    case query_status::set_flags_failed:
+        return LIBARMGPUINFO_ERROR_SET_FLAGS_FAILED;
+    case query_status::get_props_failed:
+        return LIBARMGPUINFO_ERROR_GET_PROPS_FAILED;
+    case query_status::out_of_memory:
+        return LIBARMGPUINFO_ERROR_OUT_OF_MEMORY;
+    case query_status::decode_failed:
+        return LIBARMGPUINFO_ERROR_DECODE_FAILED;
+    }
+
+    return LIBARMGPUINFO_ERROR_DECODE_FAILED;
+}
+
+/** Check that a caller-allocated result structure is usable. */
+libarmgpuinfo_result check_info(
+    const libarmgpuinfo_info* info
+) {
+    if (!info) {
+        return LIBARMGPUINFO_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (info->struct_size < LIBARMGPUINFO_INFO_SIZE_V1) {
+        return LIBARMGPUINFO_ERROR_STRUCT_TOO_SMALL;
+    }
+
+    return LIBARMGPUINFO_SUCCESS;
+}
+
+/**
+ * Write the GPU information into a caller-allocated result structure.
+ *
+ * Only the fields that fit within the caller's structure size are written.
+ */
+void write_info(
+    const gpuinfo& src,
+    libarmgpuinfo_info* dst
+) {
+    libarmgpuinfo_info result {};
+    result.struct_size = dst->struct_size;
+    result.struct_version = LIBARMGPUINFO_INFO_VERSION;
+    result.gpu_name = src.gpu_name;
+    result.architecture_name = src.architecture_name;
+    result.gpu_id = src.gpu_id;
+    result.architecture_major = src.architecture_major;
+    result.architecture_minor = src.architecture_minor;
+    result.num_shader_cores = src.num_shader_cores;
+    result.shader_core_mask = src.shader_core_mask;
+    result.num_l2_slices = src.num_l2_slices;
+    result.num_l2_bytes = src.num_l2_bytes;
+    result.num_bus_bits = src.num_bus_bits;
+    result.num_exec_engines = src.num_exec_engines;
+    result.num_fp32_fmas_per_cy = src.num_fp32_fmas_per_cy;
+    result.num_fp16_fmas_per_cy = src.num_fp16_fmas_per_cy;
+    result.num_texels_per_cy = src.num_texels_per_cy;
+    result.num_pixels_per_cy = src.num_pixels_per_cy;
+
+    result.topology.num_groups = src.topology.num_groups;
+    result.topology.num_l2_caches = src.topology.num_l2_caches;
+    for (uint32_t i = 0; i < LIBARMGPUINFO_MAX_CORE_GROUPS; i++) {
+        result.topology.groups[i].core_mask = src.topology.groups[i].core_mask;
+        result.topology.groups[i].num_cores = src.topology.groups[i].num_cores;
+        result.topology.groups[i].l2_index = src.topology.groups[i].l2_index;
+    }
+
+    result.num_l2_slice_bytes = src.num_l2_slice_bytes;
+    result.num_l2_line_bytes = src.num_l2_line_bytes;
+    for (uint32_t i = 0; i < LIBARMGPUINFO_NUM_TEXTURE_FEATURES_REGISTERS; i++) {
+        result.texture_features[i] = src.texture_features[i];
+    }
+
+    result.texture_formats = src.texture_formats;
+    result.coherency = static_cast<uint32_t>(src.coherency);
+    result.coherency_protocols = src.coherency_protocols;
+    result.num_gpu_memory_bytes = src.num_gpu_memory_bytes;
+    result.num_va_bits = src.num_va_bits;
+    result.num_pa_bits = src.num_pa_bits;
+    result.num_address_spaces = src.num_address_spaces;
+
+    result.queues.scheduler = static_cast<uint32_t>(src.queues.scheduler);
+    result.queues.num_job_slots = src.queues.num_job_slots;
+    for (uint32_t i = 0; i < LIBARMGPUINFO_MAX_JOB_SLOTS; i++) {
+        result.queues.job_slot_features[i] = src.queues.job_slot_features[i];
+    }
+
+    result.queues.num_compute_slots = src.queues.num_compute_slots;
+    result.queues.num_fragment_slots = src.queues.num_fragment_slots;
+    result.queues.csf_interface_version = src.queues.csf_interface_version;
+    result.queues.num_queue_groups = src.queues.num_queue_groups;
+    result.queues.num_queues_per_group = src.queues.num_queues_per_group;
+
+    result.tiler.tiler_features = src.tiler.tiler_features;
+    result.tiler.bin_size_bytes = src.tiler.bin_size_bytes;
+    result.tiler.max_active_levels = src.tiler.max_active_levels;
+    result.tiler.num_prims_per_cy = src.tiler.num_prims_per_cy;
+
+    result.num_threads_per_core = src.num_threads_per_core;
+    result.num_registers_per_core = src.num_registers_per_core;
+    result.num_int8_macs_per_cy = src.num_int8_macs_per_cy;
+    result.num_fp16_macs_per_cy = src.num_fp16_macs_per_cy;
+
+    // Report the newest version whose fields all fit in the caller's structure
+    if (dst->struct_size < LIBARMGPUINFO_INFO_SIZE_V2) {
+        result.struct_version = 1;
+    }
+
+    std::size_t size = dst->struct_size < sizeof(result) ? dst->struct_size : sizeof(result);
+    std::memcpy(dst, &result, size);
+}
+
+}
+
+/* See header for documentation */
+libarmgpuinfo_result libarmgpuinfo_query(
+    uint32_t device_id,
+    libarmgpuinfo_info* info
+) {
+    libarmgpuinfo_result result = check_info(info);
+    if (result != LIBARMGPUINFO_SUCCESS) {
+        return result;
+    }
+
+    const auto& driver = libarmgpuinfo::detail::system_driver;
+
+    int fd { -1 };
+    query_status status = libarmgpuinfo::detail::open_device(driver, device_id, fd);
+    if (status != query_status::success) {
+        return to_result(status);
+    }
+
+    gpuinfo device_info {};
+    libarmgpuinfo::detail::kbase_device device { driver, fd };
+    status = device.query(device_info);
+    driver.close(fd);
+
+    if (status != query_status::success) {
+        return to_result(status);
+    }
+
+    write_info(device_info, info);
+    return LIBARMGPUINFO_SUCCESS;
+}
+
+/* See header for documentation */
+libarmgpuinfo_result libarmgpuinfo_query_batch(
+    const uint32_t* device_ids,
+    size_t count,
+    libarmgpuinfo_info* infos,
+    libarmgpuinfo_result* results
+) {
+    if (!count) {
+        return LIBARMGPUINFO_SUCCESS;
+    }
+
+    if (!device_ids) {
+        return LIBARMGPUINFO_ERROR_INVALID_ARGUMENT;
+    }
+
+    libarmgpuinfo_result result = check_info(infos);
+    if (result != LIBARMGPUINFO_SUCCESS) {
+        return result;
+    }
+
+    // Elements after the first are only aligned if the stride is aligned
+    if ((infos->struct_size % alignof(libarmgpuinfo_info)) != 0) {
+        return LIBARMGPUINFO_ERROR_STRUCT_MISALIGNED;
+    }
+
+    // Elements are laid out using the caller's structure size
+    const std::size_t stride = infos->struct_size;
+    unsigned char* base = reinterpret_cast<unsigned char*>(infos);
+
+    libarmgpuinfo_result first_error = LIBARMGPUINFO_SUCCESS;
+    for (size_t i = 0; i < count; i++)
+    {
+        auto* info = reinterpret_cast<libarmgpuinfo_info*>(base + i * stride);
+        info->struct_size = static_cast<uint32_t>(stride);
+
+        result = libarmgpuinfo_query(device_ids[i], info);
+        if (results) {
+            results[i] = result;
+        }
+
+        if ((result != LIBARMGPUINFO_SUCCESS) && (first_error == LIBARMGPUINFO_SUCCESS)) {
+            first_error = result;
+        }
+    }
+
+    return first_error;
+}
+
+/* See header for documentation */
+libarmgpuinfo_result libarmgpuinfo_get_product_info(
+    uint32_t product_id,
+    uint32_t num_shader_cores,
+    uint32_t core_features,
+    uint32_t thread_features,
+    libarmgpuinfo_info* info
+) {
+    libarmgpuinfo_result result = check_info(info);
+    if (result != LIBARMGPUINFO_SUCCESS) {
+        return result;
+    }
+
+    gpuinfo product_info = libarmgpuinfo::get_product_info(
+        product_id,
+        num_shader_cores,
+        core_features,
+        thread_features);
+
+    write_info(product_info, info);
+    return LIBARMGPUINFO_SUCCESS;
+}
+
+/* See header for documentation */
+const char* libarmgpuinfo_result_string(
+    libarmgpuinfo_result result
+) {
+    switch (result) {
+    case LIBARMGPUINFO_SUCCESS:
+        return "Success";
+    case LIBARMGPUINFO_ERROR_INVALID_ARGUMENT:
+        return "Invalid argument";
+    case LIBARMGPUINFO_ERROR_STRUCT_TOO_SMALL:
+        return "Result structure too small";
+    case LIBARMGPUINFO_ERROR_DEVICE_NOT_FOUND:
+        return "Kernel driver device not found";
+    case LIBARMGPUINFO_ERROR_NOT_A_DEVICE:
+        return "Kernel driver path is not a device";
+    case LIBARMGPUINFO_ERROR_UNSUPPORTED_DRIVER:
+        return "Kernel driver version not supported";
+    case LIBARMGPUINFO_ERROR_SET_FLAGS_FAILED:
+        return "Kernel driver context configuration failed";
+    case LIBARMGPUINFO_ERROR_GET_PROPS_FAILED:
+        return "Kernel driver property query failed";
+    case LIBARMGPUINFO_ERROR_DECODE_FAILED:
+        return "Kernel driver property decode failed";
+    case LIBARMGPUINFO_ERROR_OUT_OF_MEMORY:
+        return "Out of memory";
+    case LIBARMGPUINFO_ERROR_STRUCT_MISALIGNED:
+        return "Result structure size not a multiple of its alignment";
+    }
+
+    return "Unknown result";
+}
@@ -0,0 +1,383 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief The libGPUInfo C interface.
+ *
+ * This interface provides a stable C ABI for the library, for use from C and
+ * from other languages via a foreign function interface. Results are written
+ * into caller-allocated structures, and no heap memory is allocated by the
+ * library during a query.
+ *
+ * Result structures are versioned. The caller must set the @c struct_size
+ * field to the size of the structure it was compiled against before making a
+ * query, and the library only writes fields that fit within that size. New
+ * fields are only ever appended, so a caller built against an older version
+ * of this header remains compatible with newer library versions. The
+ * @c struct_version field reports the newest version whose fields were all
+ * written:
+ *
+ *     libarmgpuinfo_info info;
+ *     info.struct_size = sizeof(info);
+ *
+ *     libarmgpuinfo_result result = libarmgpuinfo_query(0, &info);
+ *     if (result != LIBARMGPUINFO_SUCCESS)
+ *     {
+ *         printf("ERROR: %s\n", libarmgpuinfo_result_string(result));
+ *         return;
+ *     }
+ *
+ *     printf("GPU: %s MP%u\n", info.gpu_name, info.num_shader_cores);
+ */
+
+#ifndef LIBGPUINFO_C_H
+#define LIBGPUINFO_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Visibility attribute for public C API symbols. */
+#if !defined(LIBGPUINFO_C_API)
+    #define LIBGPUINFO_C_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** The current version of the libarmgpuinfo_info structure. */
+#define LIBARMGPUINFO_INFO_VERSION 2
+
+/** Maximum number of core groups that can be reported. */
+#define LIBARMGPUINFO_MAX_CORE_GROUPS 16
+
+/** Number of TEXTURE_FEATURES registers. */
+#define LIBARMGPUINFO_NUM_TEXTURE_FEATURES_REGISTERS 4
+
+/** Maximum number of hardware job slots. */
+#define LIBARMGPUINFO_MAX_JOB_SLOTS 16
+
+/** Result codes returned by the C interface. */
+typedef enum libarmgpuinfo_result
+{
+    /** The query succeeded. */
+    LIBARMGPUINFO_SUCCESS = 0,
+    /** A required pointer argument was NULL. */
+    LIBARMGPUINFO_ERROR_INVALID_ARGUMENT = 1,
+    /** The result structure size is smaller than the minimum supported size. */
+    LIBARMGPUINFO_ERROR_STRUCT_TOO_SMALL = 2,
+    /** The kernel driver device node could not be opened. */
+    LIBARMGPUINFO_ERROR_DEVICE_NOT_FOUND = 3,
+    /** The kernel driver device node is not a character device. */
+    LIBARMGPUINFO_ERROR_NOT_A_DEVICE = 4,
+    /** The kernel driver interface version is not supported. */
+    LIBARMGPUINFO_ERROR_UNSUPPORTED_DRIVER = 5,
+    /** The kernel driver context could not be configured. */
+    LIBARMGPUINFO_ERROR_SET_FLAGS_FAILED = 6,
+    /** The kernel driver property query failed. */
+    LIBARMGPUINFO_ERROR_GET_PROPS_FAILED = 7,
+    /** The kernel driver property data could not be decoded. */
+    LIBARMGPUINFO_ERROR_DECODE_FAILED = 8,
+    /** Memory allocation failed. */
+    LIBARMGPUINFO_ERROR_OUT_OF_MEMORY = 9,
+    /** The result structure size is not a multiple of the structure alignment. */
+    LIBARMGPUINFO_ERROR_STRUCT_MISALIGNED = 10
+} libarmgpuinfo_result;
+
+/**
+ * A group of shader cores that share a coherent view of memory.
+ *
+ * See the libarmgpuinfo::core_group C++ structure for field documentation.
+ */
+typedef struct libarmgpuinfo_core_group
+{
+    /** Shader core topology mask of the group */
+    uint64_t core_mask;
+
+    /** Number of shader cores in the group */
+    uint32_t num_cores;
+
+    /** Index of the L2 cache used by the group */
+    uint32_t l2_index;
+} libarmgpuinfo_core_group;
+
+/**
+ * Shader core topology.
+ *
+ * See the libarmgpuinfo::core_topology C++ structure for field documentation.
+ */
+typedef struct libarmgpuinfo_core_topology
+{
+    /** Number of valid entries in the groups array */
+    uint32_t num_groups;
+
+    /** Number of L2 caches, each of which may have multiple slices */
+    uint32_t num_l2_caches;
+
+    /** Core groups */
+    libarmgpuinfo_core_group groups[LIBARMGPUINFO_MAX_CORE_GROUPS];
+} libarmgpuinfo_core_topology;
+
+/**
+ * Work submission capabilities.
+ *
+ * See the libarmgpuinfo::queue_info C++ structure for field documentation.
+ */
+typedef struct libarmgpuinfo_queue_info
+{
+    /** GPU work scheduling interface, as a libarmgpuinfo::scheduler_type value */
+    uint32_t scheduler;
+
+    /** Number of hardware job slots */
+    uint32_t num_job_slots;
+
+    /** Raw JS_FEATURES register value of each job slot, indexed by slot */
+    uint32_t job_slot_features[LIBARMGPUINFO_MAX_JOB_SLOTS];
+
+    /** Number of job slots that accept compute jobs */
+    uint32_t num_compute_slots;
+
+    /** Number of job slots that accept fragment jobs */
+    uint32_t num_fragment_slots;
+
+    /** CSF firmware global interface version */
+    uint32_t csf_interface_version;
+
+    /** Number of CSF queue groups that can be resident at the same time */
+    uint32_t num_queue_groups;
+
+    /** Number of queues in each CSF queue group, the minimum over all groups */
+    uint32_t num_queues_per_group;
+} libarmgpuinfo_queue_info;
+
+/**
+ * Tiler configuration.
+ *
+ * See the libarmgpuinfo::tiler_info C++ structure for field documentation.
+ */
+typedef struct libarmgpuinfo_tiler_info
+{
+    /** Raw TILER_FEATURES register value, or zero if unknown */
+    uint32_t tiler_features;
+
+    /** Tiler heap bin size, in bytes */
+    uint32_t bin_size_bytes;
+
+    /** Maximum number of active hierarchy levels */
+    uint32_t max_active_levels;
+
+    /** Maximum number of primitives per clock, for the whole GPU */
+    uint32_t num_prims_per_cy;
+} libarmgpuinfo_tiler_info;
+
+/**
+ * Arm GPU information.
+ *
+ * See the libarmgpuinfo::gpuinfo C++ structure for field documentation.
+ * String pointers reference static storage inside the library, and remain
+ * valid for the lifetime of the process.
+ */
+typedef struct libarmgpuinfo_info
+{
+    /** Size of this structure in bytes, set by the caller. */
+    uint32_t struct_size;
+
+    /** Version of this structure written by the library. */
+    uint32_t struct_version;
+
+    /** GPU name */
+    const char* gpu_name;
+
+    /** GPU architecture name */
+    const char* architecture_name;
+
+    /** GPU ID */
+    uint32_t gpu_id;
+
+    /** GPU architecture major version */
+    uint32_t architecture_major;
+
+    /** GPU architecture minor version */
+    uint32_t architecture_minor;
+
+    /** Number of shader cores */
+    uint32_t num_shader_cores;
+
+    /** Shader core topology mask */
+    uint64_t shader_core_mask;
+
+    /** Number of L2 cache slices */
+    uint32_t num_l2_slices;
+
+    /** L2 cache size, summed for all slices, in bytes */
+    uint32_t num_l2_bytes;
+
+    /** GPU external bus width per cache slice, in bits */
+    uint32_t num_bus_bits;
+
+    /** Number of execution engines per core */
+    uint32_t num_exec_engines;
+
+    /** Maximum number of 32-bit floating-point FMAs per clock per core */
+    uint32_t num_fp32_fmas_per_cy;
+
+    /** Maximum number of 16-bit floating-point FMAs per clock per core */
+    uint32_t num_fp16_fmas_per_cy;
+
+    /** Maximum number of bilinear filtered texels per clock per core */
+    uint32_t num_texels_per_cy;
+
+    /** Maximum number of output pixels per clock per core */
+    uint32_t num_pixels_per_cy;
+
+    /* Version 2 fields */
+
+    /** Shader core topology, with the cores in shader_core_mask */
+    libarmgpuinfo_core_topology topology;
+
+    /** L2 cache size of each slice, in bytes */
+    uint32_t num_l2_slice_bytes;
+
+    /** L2 cache line size, in bytes */
+    uint32_t num_l2_line_bytes;
+
+    /** Raw TEXTURE_FEATURES register values, or zero if unknown */
+    uint32_t texture_features[LIBARMGPUINFO_NUM_TEXTURE_FEATURES_REGISTERS];
+
+    /** Supported compressed texture formats, as libarmgpuinfo::texture_format bits */
+    uint32_t texture_formats;
+
+    /** Coherency protocol selected by the kernel driver, as a libarmgpuinfo::coherency_protocol value */
+    uint32_t coherency;
+
+    /** Coherency protocols supported by the GPU, as libarmgpuinfo::coherency_protocol bits */
+    uint32_t coherency_protocols;
+
+    /** Maximum memory available to the GPU, in bytes */
+    uint64_t num_gpu_memory_bytes;
+
+    /** Number of GPU virtual address bits */
+    uint32_t num_va_bits;
+
+    /** Number of GPU physical address bits */
+    uint32_t num_pa_bits;
+
+    /** Number of MMU address spaces */
+    uint32_t num_address_spaces;
+
+    /** Work submission capabilities */
+    libarmgpuinfo_queue_info queues;
+
+    /** Tiler configuration */
+    libarmgpuinfo_tiler_info tiler;
+
+    /** Maximum number of resident threads per core */
+    uint32_t num_threads_per_core;
+
+    /** Register file size per core, in 32-bit registers, or zero if unknown */
+    uint32_t num_registers_per_core;
+
+    /** Maximum number of int8 dot product MACs per clock per core, or zero if unsupported */
+    uint32_t num_int8_macs_per_cy;
+
+    /** Maximum number of fp16 dot product MACs per clock per core */
+    uint32_t num_fp16_macs_per_cy;
+} libarmgpuinfo_info;
+
+/** Size of the version 1 libarmgpuinfo_info structure. */
+#define LIBARMGPUINFO_INFO_SIZE_V1 ((uint32_t)(offsetof(libarmgpuinfo_info, num_pixels_per_cy) + sizeof(uint32_t)))
+
+/** Size of the version 2 libarmgpuinfo_info structure. */
+#define LIBARMGPUINFO_INFO_SIZE_V2 ((uint32_t)(offsetof(libarmgpuinfo_info, num_fp16_macs_per_cy) + sizeof(uint32_t)))
+
+/**
+ * Query the GPU information for a device.
+ *
+ * @param device_id   The driver instance, e.g. 0 for /dev/mali0.
+ * @param info        The caller-allocated result, with struct_size set.
+ *
+ * @return The query result code.
+ */
+LIBGPUINFO_C_API libarmgpuinfo_result libarmgpuinfo_query(
+    uint32_t device_id,
+    libarmgpuinfo_info* info);
+
+/**
+ * Query the GPU information for multiple devices.
+ *
+ * The @c struct_size field of the first result structure defines the stride
+ * of the @c infos array; all elements are assumed to use the same size. The
+ * size must be a multiple of the structure alignment, so that every element
+ * is aligned.
+ *
+ * @param device_ids   The array of driver instances to query.
+ * @param count        The number of elements in each array.
+ * @param infos        The caller-allocated result array, with struct_size set.
+ * @param results      The caller-allocated per-device result codes, or NULL.
+ *
+ * @return @c LIBARMGPUINFO_SUCCESS if all queries succeeded, else the result
+ *         code of the first query that failed.
+ */
+LIBGPUINFO_C_API libarmgpuinfo_result libarmgpuinfo_query_batch(
+    const uint32_t* device_ids,
+    size_t count,
+    libarmgpuinfo_info* infos,
+    libarmgpuinfo_result* results);
+
+/**
+ * Get the GPU information for a known product configuration.
+ *
+ * This does not connect to the kernel driver; see the C++ function
+ * libarmgpuinfo::get_product_info() for details.
+ *
+ * @param product_id         The GPU product ID, e.g. 0xa002.
+ * @param num_shader_cores   The number of shader cores.
+ * @param core_features      The raw CORE_FEATURES register value.
+ * @param thread_features    The raw THREAD_FEATURES register value.
+ * @param info               The caller-allocated result, with struct_size set.
+ *
+ * @return The query result code.
+ */
+LIBGPUINFO_C_API libarmgpuinfo_result libarmgpuinfo_get_product_info(
+    uint32_t product_id,
+    uint32_t num_shader_cores,
+    uint32_t core_features,
+    uint32_t thread_features,
+    libarmgpuinfo_info* info);
+
+/**
+ * Get a human readable description of a result code.
+ *
+ * @param result   The result code.
+ *
+ * @return A static string describing the result.
+ */
+LIBGPUINFO_C_API const char* libarmgpuinfo_result_string(
+    libarmgpuinfo_result result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief The kernel driver property capture format.
+ *
+ * A capture stores the raw property data returned by a kernel driver, so that
+ * a device can be decoded offline on another machine. A capture is a fixed
+ * size header followed by the payload, with all header fields little-endian:
+ *
+ *     +--------+------+------------------------------------------+
+ *     | Offset | Size | Field                                    |
+ *     +--------+------+------------------------------------------+
+ *     |      0 |    4 | Magic, the ASCII characters "MGPC"       |
+ *     |      4 |    2 | Format version, currently 1              |
+ *     |      6 |    2 | Kernel driver interface, capture_kernel  |
+ *     |      8 |    4 | Payload size in bytes                    |
+ *     |     12 |    N | Payload                                  |
+ *     +--------+------+------------------------------------------+
+ *
+ * For post-r21 kernel drivers the payload is the property buffer returned by
+ * the get_gpuprops ioctl. For pre-r21 kernel drivers the payload is the
+ * uk_gpuprops_t structure returned by the get_gpuprops ioctl, in the Arm ABI
+ * layout with natural field alignment and little-endian fields. This layout is
+ * the same for AArch32 and AArch64 kernels, so captures from either can be
+ * decoded on any host.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace libarmgpuinfo {
+namespace detail {
+
+/** Capture magic, the characters "MGPC" as a little-endian value. */
+constexpr uint32_t capture_magic { 0x4350474d };
+
+/** Capture format version. */
+constexpr uint16_t capture_version { 1 };
+
+/** Capture header size in bytes. */
+constexpr std::size_t capture_header_size { 12 };
+
+/** Kernel driver interface of a capture. */
+enum class capture_kernel : uint16_t {
+    /** Pre-r21 JM kernel. */
+    pre_r21 = 0,
+    /** Post-r21 JM kernel. */
+    post_r21_jm = 1,
+    /** Post-r21 CSF kernel. */
+    post_r21_csf = 2
+};
+
+/** A parsed capture, referencing the payload in the capture data. */
+struct capture_view {
+    /** The kernel driver interface. */
+    capture_kernel kernel;
+
+    /** The payload data. */
+    const unsigned char* payload;
+
+    /** The payload size in bytes. */
+    std::size_t payload_size;
+};
+
+/** Load a little-endian value. */
+template <typename T>
+inline T load_le(const unsigned char* data)
+{
+    T value { 0 };
+    for (std::size_t b = 0; b < sizeof(T); b++) {
+        value |= static_cast<T>(static_cast<T>(data[b]) << (8 * b));
+    }
+
+    return value;
+}
+
+/** Store a little-endian value. */
+template <typename T>
+inline void store_le(unsigned char* data, T value)
+{
+    for (std::size_t b = 0; b < sizeof(T); b++) {
+        data[b] = static_cast<unsigned char>(value >> (8 * b));
+    }
+}
+
+/**
+ * Parse a capture.
+ *
+ * @param data   The capture data.
+ * @param size   The capture size in bytes.
+ * @param view   The returned capture view.
+ *
+ * @return @c true if the capture header is valid and the payload is complete.
+ */
+inline bool parse_capture(
+    const unsigned char* data,
+    std::size_t size,
+    capture_view& view
+) {
+    if (!data || (size < capture_header_size)) {
+        return false;
+    }
+
+    if ((load_le<uint32_t>(data) != capture_magic) ||
+        (load_le<uint16_t>(data + 4) != capture_version)) {
+        return false;
+    }
+
+    uint16_t kernel = load_le<uint16_t>(data + 6);
+    if (kernel > static_cast<uint16_t>(capture_kernel::post_r21_csf)) {
+        return false;
+    }
+
+    uint32_t payload_size = load_le<uint32_t>(data + 8);
+    if (payload_size != (size - capture_header_size)) {
+        return false;
+    }
+
+    view.kernel = static_cast<capture_kernel>(kernel);
+    view.payload = data + capture_header_size;
+    view.payload_size = payload_size;
+    return true;
+}
+
+/**
+ * Write a capture header.
+ *
+ * @param kernel         The kernel driver interface.
+ * @param payload_size   The payload size in bytes.
+ * @param header         The header storage, of capture_header_size bytes.
+ */
+inline void write_capture_header(
+    capture_kernel kernel,
+    uint32_t payload_size,
+    unsigned char* header
+) {
+    store_le<uint32_t>(header, capture_magic);
+    store_le<uint16_t>(header + 4, capture_version);
+    store_le<uint16_t>(header + 6, static_cast<uint16_t>(kernel));
+    store_le<uint32_t>(header + 8, payload_size);
+}
+
+}
+}
@@ -0,0 +1,803 @@
+/*
+ * Copyright (c) 2021-2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief The kernel driver property decoders.
+ *
+ * The post-r21 kernel driver returns the GPU properties as a packed buffer of
+ * key-value pairs, and the pre-r21 kernel driver returns them as a fixed
+ * structure. This header contains the decoders that convert them into the GPU
+ * information structure.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "libgpuinfo.hpp"
+#include "libgpuinfo_capture.hpp"
+#include "libgpuinfo_kbase.hpp"
+#include "libgpuinfo_products.hpp"
+
+namespace libarmgpuinfo {
+namespace detail {
+
+/**
+ * Decode a log2 encoded property value.
+ *
+ * Property data is untrusted, so values that cannot be represented decode as
+ * zero rather than overflowing the shift.
+ *
+ * @param log2   The log2 encoded value.
+ *
+ * @return The decoded value, or zero if out of range.
+ */
+inline uint64_t decode_log2(uint64_t log2)
+{
+    return (log2 < 64) ? (1ULL << log2) : 0;
+}
+
+/**
+ * Set the shader core topology from the decoded core groups.
+ *
+ * The shader core mask and count are derived from the union of all groups.
+ * Group counts are untrusted, so are clamped to the supported range.
+ *
+ * @param group_masks     The core mask of each group.
+ * @param num_groups      The number of valid groups.
+ * @param num_l2_caches   The number of L2 caches.
+ * @param info            The device property information to update.
+ */
+inline void set_topology(
+    const uint64_t (&group_masks)[max_core_groups],
+    uint32_t num_groups,
+    uint32_t num_l2_caches,
+    gpuinfo& info
+) {
+    if (num_groups > max_core_groups) {
+        num_groups = max_core_groups;
+    }
+
+    if (!num_l2_caches || (num_l2_caches > max_core_groups)) {
+        num_l2_caches = 1;
+    }
+
+    auto& topology = info.topology;
+    topology = core_topology {};
+    topology.num_groups = num_groups;
+    topology.num_l2_caches = num_l2_caches;
+
+    info.shader_core_mask = 0;
+    for (uint32_t i = 0; i < num_groups; i++) {
+        auto& group = topology.groups[i];
+        group.core_mask = group_masks[i];
+        group.num_cores = __builtin_popcountll(group_masks[i]);
+
+        // Multi-group GPUs have one L2 cache per core group
+        group.l2_index = (i < num_l2_caches) ? i : 0;
+
+        info.shader_core_mask |= group_masks[i];
+    }
+
+    info.num_shader_cores = __builtin_popcountll(info.shader_core_mask);
+}
+
+/**
+ * Decode the supported compressed texture formats.
+ *
+ * Each bit in TEXTURE_FEATURES_0 indicates support for the hardware texture
+ * format with that index. Format families are reported if every format in
+ * the family is supported.
+ *
+ * @param texture_features_0   The TEXTURE_FEATURES_0 register value.
+ *
+ * @return The supported formats, as texture_format bits.
+ */
+inline uint32_t decode_texture_formats(
+    uint32_t texture_features_0
+) {
+    /** Hardware texture formats in each texture format family. */
+    struct format_family {
+        texture_format format;
+        uint32_t hw_formats;
+    };
+
+    constexpr format_family families[] {
+        { texture_format::etc2,        (1U << 1) | (1U << 3) | (1U << 19) },
+        { texture_format::eac,         (1U << 2) | (1U << 4) | (1U << 17) | (1U << 18) },
+        { texture_format::bc1,         (1U << 7) },
+        { texture_format::bc2,         (1U << 8) },
+        { texture_format::bc3,         (1U << 9) },
+        { texture_format::bc4,         (1U << 10) | (1U << 11) },
+        { texture_format::bc5,         (1U << 12) | (1U << 13) },
+        { texture_format::bc6h,        (1U << 14) | (1U << 15) },
+        { texture_format::bc7,         (1U << 16) },
+        { texture_format::astc_3d_ldr, (1U << 20) },
+        { texture_format::astc_3d_hdr, (1U << 21) },
+        { texture_format::astc_ldr,    (1U << 22) },
+        { texture_format::astc_hdr,    (1U << 23) }
+    };
+
+    uint32_t formats { 0 };
+    for (const auto& family : families) {
+        if ((texture_features_0 & family.hw_formats) == family.hw_formats) {
+            formats |= 1U << static_cast<uint32_t>(family.format);
+        }
+    }
+
+    return formats;
+}
+
+/**
+ * Decode a kernel driver coherency mode.
+ *
+ * The kernel driver reports the selected mode as the COHERENCY_ENABLE register
+ * value, where 0 is ACE-Lite, 1 is ACE, and 31 is no coherency. Unknown
+ * values decode as no coherency, which is always safe.
+ *
+ * @param mode   The raw coherency mode.
+ *
+ * @return The coherency protocol.
+ */
+inline coherency_protocol decode_coherency_mode(
+    uint64_t mode
+) {
+    switch (mode) {
+    case 0:
+        return coherency_protocol::ace_lite;
+    case 1:
+        return coherency_protocol::ace;
+    default:
+        return coherency_protocol::none;
+    }
+}
+
+/**
+ * Decode the supported coherency protocols.
+ *
+ * @param features   The COHERENCY_FEATURES register value, where each bit
+ *                   indicates support for the coherency mode of that index.
+ *
+ * @return The supported protocols, as coherency_protocol bits.
+ */
+inline uint32_t decode_coherency_features(
+    uint64_t features
+) {
+    uint32_t protocols { 1U << static_cast<uint32_t>(coherency_protocol::none) };
+
+    for (uint64_t mode = 0; mode < 2; mode++) {
+        if (features & (1ULL << mode)) {
+            protocols |= 1U << static_cast<uint32_t>(decode_coherency_mode(mode));
+        }
+    }
+
+    return protocols;
+}
+
+/**
+ * Decode the MMU_FEATURES register.
+ *
+ * @param features   The MMU_FEATURES register value, which stores the number
+ *                   of virtual address bits in bits [7:0] and the number of
+ *                   physical address bits in bits [15:8].
+ * @param info       The device property information to update.
+ */
+inline void decode_mmu_features(
+    uint64_t features,
+    gpuinfo& info
+) {
+    info.num_va_bits = features & 0xFF;
+    info.num_pa_bits = (features >> 8) & 0xFF;
+}
+
+/**
+ * Set the job slot capabilities.
+ *
+ * @param js_present    The JS_PRESENT register value.
+ * @param js_features   The JS_FEATURES register value of each job slot.
+ * @param info          The device property information to update.
+ */
+inline void set_job_slots(
+    uint64_t js_present,
+    const uint32_t (&js_features)[max_job_slots],
+    gpuinfo& info
+) {
+    constexpr uint32_t compute_job { 1U << 4 };
+    constexpr uint32_t fragment_job { 1U << 9 };
+
+    auto& queues = info.queues;
+    queues.num_job_slots = 0;
+    queues.num_compute_slots = 0;
+    queues.num_fragment_slots = 0;
+
+    for (uint32_t slot = 0; slot < max_job_slots; slot++) {
+        const bool present = (js_present >> slot) & 1;
+        const uint32_t features = present ? js_features[slot] : 0;
+        queues.job_slot_features[slot] = features;
+
+        queues.num_job_slots += present ? 1 : 0;
+        queues.num_compute_slots += (features & compute_job) ? 1 : 0;
+        queues.num_fragment_slots += (features & fragment_job) ? 1 : 0;
+    }
+}
+
+class prop_decoder {
+  public:
+    prop_decoder(const unsigned char* data, std::size_t size)
+        : data_{ data }
+        , size_{ size } {}
+
+    bool decode(gpuinfo& info) {
+        bool success = true;
+
+        uint64_t raw_gpu_id {};
+        uint64_t raw_core_features {};
+        uint64_t raw_thread_features {};
+
+        uint64_t group_masks[max_core_groups] {};
+        uint32_t num_groups { 0 };
+        uint32_t num_core_groups { 0 };
+
+        uint64_t js_present { 0 };
+        uint32_t js_features[max_job_slots] {};
+
+        while (size_ > 0) {
+            auto p = next(success);
+            if (!success) {
+                return false;
+            }
+
+            prop_id_t id = p.first;
+            uint64_t value = p.second;
+
+            switch (id) {
+            case prop_id_t::product_id:
+                info.gpu_id = get_gpu_id(value);
+                break;
+            case prop_id_t::texture_features_0:
+            case prop_id_t::texture_features_1:
+            case prop_id_t::texture_features_2:
+                info.texture_features[static_cast<uint32_t>(id) - static_cast<uint32_t>(prop_id_t::texture_features_0)] = value;
+                break;
+            case prop_id_t::texture_features_3:
+                info.texture_features[3] = value;
+                break;
+            case prop_id_t::l2_log2_line_size:
+                info.num_l2_line_bytes = decode_log2(value);
+                break;
+            case prop_id_t::l2_log2_cache_size:
+                info.num_l2_slice_bytes = decode_log2(value);
+                break;
+            case prop_id_t::l2_num_l2_slices:
+                info.num_l2_slices = value;
+                break;
+            case prop_id_t::raw_l2_features:
+                // Bus width stored as log2(bus width) in top 8 bits
+                info.num_bus_bits = decode_log2((value >> 24) & 0xFF);
+                break;
+            case prop_id_t::raw_gpu_id:
+                raw_gpu_id = value;
+                break;
+            case prop_id_t::raw_core_features:
+                raw_core_features = value;
+                break;
+            case prop_id_t::raw_thread_features:
+                raw_thread_features = value;
+                break;
+            case prop_id_t::gpu_available_memory_size:
+                info.num_gpu_memory_bytes = value;
+                break;
+            case prop_id_t::raw_mmu_features:
+                decode_mmu_features(value, info);
+                break;
+            case prop_id_t::raw_as_present:
+                info.num_address_spaces = __builtin_popcountll(value);
+                break;
+            case prop_id_t::raw_js_present:
+                js_present = value;
+                break;
+            case prop_id_t::max_threads:
+                info.num_threads_per_core = value;
+                break;
+            case prop_id_t::max_registers:
+                info.num_registers_per_core = value;
+                break;
+            case prop_id_t::tiler_bin_size_bytes:
+                info.tiler.bin_size_bytes = value;
+                break;
+            case prop_id_t::tiler_max_active_levels:
+                info.tiler.max_active_levels = value;
+                break;
+            case prop_id_t::raw_tiler_features:
+                info.tiler.tiler_features = value;
+                break;
+            case prop_id_t::raw_coherency_mode:
+                info.coherency = decode_coherency_mode(value);
+                break;
+            case prop_id_t::coherency_coherency:
+                info.coherency_protocols = decode_coherency_features(value);
+                break;
+            case prop_id_t::coherency_num_groups:
+                num_groups = (value < max_core_groups) ? value : max_core_groups;
+                break;
+            case prop_id_t::coherency_num_core_groups:
+                num_core_groups = (value <= max_core_groups) ? value : 0;
+                break;
+            case prop_id_t::coherency_group_0:
+            case prop_id_t::coherency_group_1:
+            case prop_id_t::coherency_group_2:
+            case prop_id_t::coherency_group_3:
+            case prop_id_t::coherency_group_4:
+            case prop_id_t::coherency_group_5:
+            case prop_id_t::coherency_group_6:
+            case prop_id_t::coherency_group_7:
+            case prop_id_t::coherency_group_8:
+            case prop_id_t::coherency_group_9:
+            case prop_id_t::coherency_group_10:
+            case prop_id_t::coherency_group_11:
+            case prop_id_t::coherency_group_12:
+            case prop_id_t::coherency_group_13:
+            case prop_id_t::coherency_group_14:
+            case prop_id_t::coherency_group_15:
+                group_masks[static_cast<uint32_t>(id) - static_cast<uint32_t>(prop_id_t::coherency_group_0)] = value;
+                break;
+            case prop_id_t::raw_js_features_0:
+            case prop_id_t::raw_js_features_1:
+            case prop_id_t::raw_js_features_2:
+            case prop_id_t::raw_js_features_3:
+            case prop_id_t::raw_js_features_4:
+            case prop_id_t::raw_js_features_5:
+            case prop_id_t::raw_js_features_6:
+            case prop_id_t::raw_js_features_7:
+            case prop_id_t::raw_js_features_8:
+            case prop_id_t::raw_js_features_9:
+            case prop_id_t::raw_js_features_10:
+            case prop_id_t::raw_js_features_11:
+            case prop_id_t::raw_js_features_12:
+            case prop_id_t::raw_js_features_13:
+            case prop_id_t::raw_js_features_14:
+            case prop_id_t::raw_js_features_15:
+                js_features[static_cast<uint32_t>(id) - static_cast<uint32_t>(prop_id_t::raw_js_features_0)] = value;
+                break;
+            default:
+                break;
+            }
+        }
+
+        set_job_slots(js_present, js_features, info);
+
+        // Older kernel drivers may not report the group counts, so fall back
+        // to the highest group with any cores
+        if (!num_groups) {
+            for (uint32_t i = 0; i < max_core_groups; i++) {
+                if (group_masks[i]) {
+                    num_groups = i + 1;
+                }
+            }
+        }
+
+        set_topology(group_masks, num_groups, num_core_groups, info);
+
+        // Decode architecture versions
+        constexpr uint64_t bits4 { 0xF };
+        constexpr uint64_t bits8 { 0xFF };
+
+        constexpr uint64_t compat_shift { 28 };
+        constexpr uint64_t compat { 0xF };
+        bool is_64bit_id = ((raw_gpu_id >> compat_shift) & bits4) == compat;
+
+        // Old-style 32-bit ID
+        if (!is_64bit_id)
+        {
+            constexpr uint64_t arch_major_offset { 28 };
+            constexpr uint64_t arch_minor_offset { 24 };
+            info.architecture_major = (raw_gpu_id >> arch_major_offset) & bits4;
+            info.architecture_minor = (raw_gpu_id >> arch_minor_offset) & bits4;
+        }
+        // New-style 64-bit ID
+        else
+        {
+            constexpr uint64_t arch_major_offset { 56 };
+            constexpr uint64_t arch_minor_offset { 48 };
+            info.architecture_major = (raw_gpu_id >> arch_major_offset) & bits8;
+            info.architecture_minor = (raw_gpu_id >> arch_minor_offset) & bits8;
+        }
+
+        info.num_exec_engines = get_num_exec_engines(
+            info.gpu_id,
+            info.num_shader_cores,
+            raw_core_features,
+            raw_thread_features);
+
+        info.num_fp32_fmas_per_cy = get_num_fp32_fmas(
+            info.gpu_id,
+            info.num_shader_cores,
+            raw_core_features,
+            raw_thread_features);
+
+        info.num_fp16_fmas_per_cy = info.num_fp32_fmas_per_cy * 2;
+
+        info.num_int8_macs_per_cy = get_num_int8_macs(
+            info.gpu_id,
+            info.num_shader_cores,
+            raw_core_features,
+            raw_thread_features);
+
+        info.num_fp16_macs_per_cy = get_num_fp16_macs(
+            info.gpu_id,
+            info.num_shader_cores,
+            raw_core_features,
+            raw_thread_features);
+
+        info.num_texels_per_cy = get_num_texels(
+            info.gpu_id,
+            info.num_shader_cores,
+            raw_core_features,
+            raw_thread_features);
+
+        info.num_pixels_per_cy = get_num_pixels(
+            info.gpu_id,
+            info.num_shader_cores,
+            raw_core_features,
+            raw_thread_features);
+
+        return true;
+    }
+
+  private:
+    /** Property id type. */
+    using prop_id_t = kbase_post_r21::get_gpuprops_t::gpuprop_code;
+    /** Property size type. */
+    using prop_size_t = kbase_post_r21::get_gpuprops_t::gpuprop_size;
+
+    static std::pair<prop_id_t, prop_size_t> to_prop_metadata(uint32_t v)  {
+        /* Property id/size encoding is:
+         * +--------+----------+
+         * | 31   2 | 1      0 |
+         * +--------+----------+
+         * | PropId | PropSize |
+         * +--------+----------+
+         */
+        constexpr unsigned int id_shift { 2 };
+        constexpr unsigned int size_mask { 0b11 };
+
+        return { static_cast<prop_id_t>(v >> id_shift), static_cast<prop_size_t>(v & size_mask) };
+    }
+
+    std::pair<prop_id_t, uint64_t> next(bool& success)  {
+        success = true;
+        auto p = to_prop_metadata(read_bytes<uint32_t>(success));
+        if (success)
+        {
+            prop_id_t id = p.first;
+            prop_size_t size = p.second;
+
+            switch (size) {
+            case prop_size_t::uint8:
+                return { id, read_bytes<uint8_t>(success) };
+            case prop_size_t::uint16:
+                return { id, read_bytes<uint16_t>(success) };
+            case prop_size_t::uint32:
+                return { id, read_bytes<uint32_t>(success) };
+            case prop_size_t::uint64:
+                return { id, read_bytes<uint64_t>(success) };
+            }
+        }
+
+        return {};
+    }
+
+    template <typename T>
+    T read_bytes(bool& success)  {
+        // Check we have enough bytes in the buffer
+        if (size_ < sizeof(T)) {
+            success = false;
+            return 0;
+        }
+
+        T ret {};
+        for (size_t b = 0; b < sizeof(T); b++)
+        {
+            ret |= static_cast<T>(static_cast<uint64_t>(data_[b]) << (8 * b));
+        }
+        data_ += sizeof(T);
+        size_ -= sizeof(T);
+        return ret;
+    }
+
+    unsigned char const *data_;
+    std::size_t size_;
+};
+
+/**
+ * Size of the pre-r21 property structure in the Arm ABI layout.
+ *
+ * The AArch32 AAPCS and AArch64 ABIs both align 64-bit fields to 8 bytes, so
+ * 32-bit and 64-bit kernel drivers use the same layout.
+ */
+constexpr std::size_t pre_r21_props_size { 536 };
+
+/**
+ * Layout-independent reader for the pre-r21 property structure.
+ *
+ * A device can overlay the structure returned by its own kernel driver, but a
+ * capture decoded on another host cannot, because the host ABI may pad the
+ * structure differently or use a different byte order. This reader reads each
+ * field from its offset in the little-endian Arm ABI layout instead, so it
+ * gives the same result on any host.
+ */
+class pre_r21_reader {
+  public:
+    pre_r21_reader(const unsigned char* data, std::size_t size)
+        : data_{ data }
+        , size_{ size } {}
+
+    /**
+     * Read the property structure.
+     *
+     * @param result   The returned property structure, in the host layout.
+     *
+     * @return @c true if the data is a complete structure, @c false otherwise.
+     */
+    bool read(kbase_pre_r21::uk_gpuprops_t& result) {
+        if (!data_ || (size_ != pre_r21_props_size)) {
+            return false;
+        }
+
+        offset_ = 0;
+        kbase_pre_r21::uk_gpuprops_t out {};
+        auto& props = out.props;
+
+        // The header is only meaningful to the kernel driver
+        offset_ += sizeof(uint64_t);
+
+        auto& core = props.core_props;
+        field(core.product_id);
+        field(core.version_status);
+        field(core.minor_revision);
+        field(core.major_revision);
+        field(core.padding);
+        field(core.gpu_speed_mhz);
+        field(core.gpu_freq_khz_max);
+        field(core.gpu_freq_khz_min);
+        field(core.log2_program_counter_size);
+        array(core.texture_features);
+        field(core.gpu_available_memory_size);
+
+        auto& l2 = props.l2_props;
+        field(l2.log2_line_size);
+        field(l2.log2_cache_size);
+        field(l2.num_l2_slices);
+        array(l2.padding);
+
+        field(props.unused);
+
+        auto& tiler = props.tiler_props;
+        field(tiler.bin_size_bytes);
+        field(tiler.max_active_levels);
+
+        auto& thread = props.thread_props;
+        field(thread.max_threads);
+        field(thread.max_workgroup_size);
+        field(thread.max_barrier_size);
+        field(thread.max_registers);
+        field(thread.max_task_queue);
+        field(thread.max_thread_group_split);
+        field(thread.impl_tech);
+        array(thread.padding);
+
+        auto& raw = props.raw_props;
+        field(raw.shader_present);
+        field(raw.tiler_present);
+        field(raw.l2_present);
+        field(raw.unused_1);
+        field(raw.l2_features);
+        field(raw.suspend_size);
+        field(raw.mem_features);
+        field(raw.mmu_features);
+        field(raw.as_present);
+        field(raw.js_present);
+        array(raw.js_features);
+        field(raw.tiler_features);
+        array(raw.texture_features);
+        field(raw.gpu_id);
+        field(raw.thread_max_threads);
+        field(raw.thread_max_workgroup_size);
+        field(raw.thread_max_barrier_size);
+        field(raw.thread_features);
+        field(raw.coherency_mode);
+
+        auto& coherency = props.coherency_info;
+        field(coherency.num_groups);
+        field(coherency.num_core_groups);
+        field(coherency.coherency);
+        field(coherency.padding);
+        for (auto& group : coherency.group) {
+            field(group.core_mask);
+            field(group.num_cores);
+            array(group.padding);
+        }
+
+        if (offset_ != size_) {
+            return false;
+        }
+
+        result = out;
+        return true;
+    }
+
+  private:
+    /** Read a field, aligned to its natural alignment as in the Arm ABIs. */
+    template <typename T>
+    void field(T& value) {
+        offset_ = (offset_ + sizeof(T) - 1) & ~(sizeof(T) - 1);
+        if ((offset_ + sizeof(T)) > size_) {
+            // Fail the read, without reading beyond the end of the data
+            value = 0;
+            offset_ = size_ + 1;
+            return;
+        }
+
+        value = load_le<T>(data_ + offset_);
+        offset_ += sizeof(T);
+    }
+
+    /** Read an array field. */
+    template <typename T, std::size_t N>
+    void array(T (&values)[N]) {
+        for (auto& value : values) {
+            field(value);
+        }
+    }
+
+    const unsigned char* data_;
+    std::size_t size_;
+    std::size_t offset_ { 0 };
+};
+
+/**
+ * Decode the pre-r21 kernel driver property structure.
+ *
+ * @param props   The property structure returned by the kernel driver.
+ * @param info    The returned device property information.
+ */
+inline void decode_pre_r21_props(
+    const kbase_pre_r21::uk_gpuprops_t& props,
+    gpuinfo& info
+) {
+    info.gpu_id = get_gpu_id(props.props.core_props.product_id);
+    for (uint32_t i = 0; i < kbase_pre_r21::base_gpu_num_texture_features_registers; i++)
+    {
+        info.texture_features[i] = props.props.core_props.texture_features[i];
+    }
+
+    info.num_l2_line_bytes = decode_log2(props.props.l2_props.log2_line_size);
+    info.num_l2_slice_bytes = decode_log2(props.props.l2_props.log2_cache_size);
+    info.num_l2_slices = props.props.l2_props.num_l2_slices;
+    info.num_bus_bits = decode_log2(props.props.raw_props.l2_features >> 24);
+
+    // Old kernel driver must have 32-bit GPU ID
+    get_architecture_version(
+        info.gpu_id,
+        props.props.raw_props.gpu_id,
+        info.architecture_major,
+        info.architecture_minor);
+
+    info.num_gpu_memory_bytes = props.props.core_props.gpu_available_memory_size;
+    decode_mmu_features(props.props.raw_props.mmu_features, info);
+    info.num_address_spaces = __builtin_popcountll(props.props.raw_props.as_present);
+
+    static_assert(sizeof(props.props.raw_props.js_features) == sizeof(uint32_t[max_job_slots]),
+                  "Unexpected number of job slots");
+    set_job_slots(props.props.raw_props.js_present, props.props.raw_props.js_features, info);
+
+    info.num_threads_per_core = props.props.thread_props.max_threads;
+    info.num_registers_per_core = props.props.thread_props.max_registers;
+
+    info.tiler.tiler_features = props.props.raw_props.tiler_features;
+    info.tiler.bin_size_bytes = props.props.tiler_props.bin_size_bytes;
+    info.tiler.max_active_levels = props.props.tiler_props.max_active_levels;
+
+    info.coherency = decode_coherency_mode(props.props.raw_props.coherency_mode);
+    info.coherency_protocols = decode_coherency_features(props.props.coherency_info.coherency);
+
+    // Only num_groups entries of the group array are valid, but the count
+    // is not trusted so is clamped when setting the topology
+    const auto& coherency = props.props.coherency_info;
+    static_assert(kbase_pre_r21::base_max_coherent_groups == max_core_groups,
+                  "Unexpected number of coherent groups");
+
+    uint64_t group_masks[max_core_groups] {};
+    for (uint32_t i = 0; i < max_core_groups; i++)
+    {
+        group_masks[i] = coherency.group[i].core_mask;
+    }
+
+    set_topology(group_masks, coherency.num_groups, coherency.num_core_groups, info);
+
+    info.num_exec_engines = get_num_exec_engines(
+        info.gpu_id,
+        info.num_shader_cores,
+        0, 0);
+
+    info.num_fp32_fmas_per_cy = get_num_fp32_fmas(
+        info.gpu_id,
+        info.num_shader_cores,
+        0, 0);
+
+    info.num_fp16_fmas_per_cy = info.num_fp32_fmas_per_cy * 2;
+
+    info.num_int8_macs_per_cy = get_num_int8_macs(
+        info.gpu_id,
+        info.num_shader_cores,
+        0, 0);
+
+    info.num_fp16_macs_per_cy = get_num_fp16_macs(
+        info.gpu_id,
+        info.num_shader_cores,
+        0, 0);
+
+    info.num_texels_per_cy = get_num_texels(
+        info.gpu_id,
+        info.num_shader_cores,
+        0, 0);
+
+    info.num_pixels_per_cy = get_num_pixels(
+        info.gpu_id,
+        info.num_shader_cores,
+        0, 0);
+}
+
+/**
+ * Complete the information derived from the decoded device properties.
+ *
+ * @param info   The device property information to update.
+ */
+inline void finalize_info(
+    gpuinfo& info
+) {
+    info.num_l2_bytes = info.num_l2_slice_bytes * info.num_l2_slices;
+    info.texture_formats = decode_texture_formats(info.texture_features[0]);
+
+    // Kernel drivers that omit the decoded tiler properties still report the
+    // raw TILER_FEATURES register, which stores log2(bin size) in bits [5:0]
+    // and the maximum active levels in bits [11:8]
+    const uint32_t tiler_features = info.tiler.tiler_features;
+    if (!info.tiler.bin_size_bytes && tiler_features) {
+        info.tiler.bin_size_bytes = decode_log2(tiler_features & 0x3F);
+        info.tiler.max_active_levels = (tiler_features >> 8) & 0xF;
+    }
+
+    info.tiler.num_prims_per_cy = get_num_tiler_prims(info.gpu_id);
+    if (!info.num_threads_per_core) {
+        info.num_threads_per_core = get_num_threads(info.gpu_id);
+    }
+    info.gpu_name = get_gpu_name(info.gpu_id, info.num_shader_cores);
+    info.architecture_name = get_architecture_name(info.gpu_id);
+}
+
+}
+}
@@ -0,0 +1,623 @@
+/*
+ * Copyright (c) 2021-2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief The kernel driver connection.
+ *
+ * This header contains the kernel driver connection used to query the GPU
+ * properties. It is shared by the C++ and C interfaces.
+ */
+
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <new>
+
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "libgpuinfo.hpp"
+#include "libgpuinfo_decoder.hpp"
+#include "libgpuinfo_kbase.hpp"
+#include "libgpuinfo_products.hpp"
+
+/**
+ * Kernel driver backends included in the build.
+ *
+ * Each backend can be disabled at compile time, e.g. for a product that only
+ * ships CSF kernel drivers. Disabled backends are replaced by stubs, so their
+ * probe and query code is not included in the build.
+ */
+#if !defined(LIBGPUINFO_BACKEND_PRE_R21)
+    #define LIBGPUINFO_BACKEND_PRE_R21 1
+#endif
+
+#if !defined(LIBGPUINFO_BACKEND_POST_R21_JM)
+    #define LIBGPUINFO_BACKEND_POST_R21_JM 1
+#endif
+
+#if !defined(LIBGPUINFO_BACKEND_POST_R21_CSF)
+    #define LIBGPUINFO_BACKEND_POST_R21_CSF 1
+#endif
+
+#if !LIBGPUINFO_BACKEND_PRE_R21 && !LIBGPUINFO_BACKEND_POST_R21_JM && !LIBGPUINFO_BACKEND_POST_R21_CSF
+    #error "At least one kernel driver backend must be enabled"
+#endif
+
+namespace libarmgpuinfo {
+namespace detail {
+
+inline bool is_supported(unsigned int major, unsigned int minor)
+{
+    return (major > 10) || ((major == 10) && (minor >= 2));
+}
+
+/** Status of a kernel driver query. */
+enum class query_status {
+    /** Query succeeded. */
+    success,
+    /** Kernel driver device node could not be opened. */
+    open_failed,
+    /** Kernel driver device node is not a character device. */
+    not_a_device,
+    /** Kernel driver interface version is not supported. */
+    unsupported_version,
+    /** Kernel driver context flags could not be set. */
+    set_flags_failed,
+    /** Kernel driver property query failed. */
+    get_props_failed,
+    /** Memory allocation for the property query failed. */
+    out_of_memory,
+    /** Kernel driver property data could not be decoded. */
+    decode_failed
+};
+
+/** System call wrappers for the real kernel driver. */
+inline int system_open(const char* path, int flags)
+{
+    return ::open(path, flags);
+}
+
+inline int system_close(int fd)
+{
+    return ::close(fd);
+}
+
+inline int system_fstat(int fd, struct stat* buf)
+{
+    return ::fstat(fd, buf);
+}
+
+inline int system_ioctl(int fd, unsigned long request, void* arg)
+{
+    return ::ioctl(fd, request, arg);
+}
+
+/**
+ * Get the kernel memory used by a real kernel driver instance.
+ *
+ * The kbase debugfs gpu_memory file starts with the total number of pages used
+ * by all contexts of the device, followed by the pages used by each context.
+ */
+inline int64_t system_memory_usage(uint32_t id)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/kernel/debug/mali%u/gpu_memory", id);
+
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return -1;
+    }
+
+    char name[32];
+    unsigned long long num_pages { 0 };
+    const int fields = fscanf(file, "%31s %llu", name, &num_pages);
+    fclose(file);
+
+    const long page_bytes = sysconf(_SC_PAGESIZE);
+    if ((fields != 2) || (page_bytes <= 0)) {
+        return -1;
+    }
+
+    return static_cast<int64_t>(num_pages * static_cast<unsigned long long>(page_bytes));
+}
+
+/** System call interface for the real kernel driver. */
+constexpr driver_interface system_driver {
+    system_open,
+    system_close,
+    system_fstat,
+    system_ioctl,
+    system_memory_usage
+};
+
+/**
+ * Get the kernel memory used by a kernel driver instance.
+ *
+ * @param driver   The kernel driver system call interface.
+ * @param id       The driver instance, e.g. 0 for /dev/mali0.
+ *
+ * @return The memory in bytes, or a negative value if unknown.
+ */
+inline int64_t get_memory_usage(
+    const driver_interface& driver,
+    uint32_t id
+) {
+    return driver.memory_usage ? driver.memory_usage(id) : -1;
+}
+
+/** Kernel driver file descriptor and the system call interface used to access it. */
+struct connection {
+    /** The kernel driver system call interface. */
+    const driver_interface& driver;
+
+    /** The kernel driver file descriptor. */
+    int fd;
+
+    /** Issue an ioctl on the kernel driver. */
+    int ioctl(unsigned long request, void* arg) const {
+        return driver.ioctl(fd, request, arg);
+    }
+};
+
+/**
+ * Open the kernel driver device node.
+ *
+ * @param driver   The kernel driver system call interface.
+ * @param id       The driver instance, e.g. 0 for /dev/mali0.
+ * @param fd       The returned file descriptor, which is owned by the caller.
+ *
+ * @return The query status.
+ */
+inline query_status open_device(
+    const driver_interface& driver,
+    uint32_t id,
+    int& fd
+) {
+    char device_path[32];
+    snprintf(device_path, sizeof(device_path), "/dev/mali%u", id);
+
+    // Open the kernel driver device node
+    fd = driver.open(device_path, O_RDONLY);
+    if (fd < 0) {
+        return query_status::open_failed;
+    }
+
+    // Check that it is a character device
+    struct stat s {};
+    const int fs_result = driver.fstat(fd, &s);
+    if ((fs_result < 0) || (S_ISCHR(s.st_mode) == 0)) {
+        driver.close(fd);
+        fd = -1;
+        return query_status::not_a_device;
+    }
+
+    return query_status::success;
+}
+
+/** Kernel driver backend type. */
+enum class backend_type {
+    /** Pre-r21 JM kernel. */
+    pre_r21,
+    /** Post-r21 JM kernel. */
+    post_r21_jm,
+    /** Post-r21 CSF kernel. */
+    post_r21_csf
+};
+
+/** Test if a kernel driver backend is included in the build. */
+constexpr bool is_backend_enabled(
+    backend_type type
+) {
+    return (type == backend_type::pre_r21) ? LIBGPUINFO_BACKEND_PRE_R21 :
+           (type == backend_type::post_r21_jm) ? LIBGPUINFO_BACKEND_POST_R21_JM :
+           LIBGPUINFO_BACKEND_POST_R21_CSF;
+}
+
+/** Context creation flags used for all kernel driver connections. */
+constexpr uint32_t system_monitor_flag_submit_disabled_bit { 1 };
+constexpr uint32_t system_monitor_flag { 1U << system_monitor_flag_submit_disabled_bit };
+
+/**
+ * Test if setting the kernel driver context flags succeeded, using errno.
+ *
+ * Each query opens a new descriptor and sets the flags once, so the library
+ * itself never reinitializes a context. Two failures are still accepted,
+ * because the property query that follows is the authoritative check:
+ *
+ * - EPERM, if the descriptor was already set up, for example by a
+ *   driver_interface that shares descriptors. The existing context can still
+ *   be queried.
+ * - EINVAL, if the driver rejects the system monitor flag. If this leaves the
+ *   descriptor without a context, the property query fails instead.
+ */
+inline bool is_set_flags_success()
+{
+    return errno == 0 || errno == EINVAL || errno == EPERM;
+}
+
+/**
+ * Kernel driver backend.
+ *
+ * The primary template is the stub used for disabled backends, which never
+ * matches a kernel driver. Each enabled backend is an explicit specialization.
+ */
+template <backend_type type, bool enabled = is_backend_enabled(type)>
+struct backend {
+    /**
+     * Probe for this kernel driver interface.
+     *
+     * @param conn        The kernel driver connection.
+     * @param supported   Set to whether the driver version is supported.
+     *
+     * @return @c true if the kernel driver uses this interface.
+     */
+    static bool probe(const connection& conn, bool& supported) {
+        unused(conn);
+        unused(supported);
+        return false;
+    }
+
+    /** Configure Mali kernel driver connection flags. */
+    static bool set_flags(const connection& conn) {
+        unused(conn);
+        return false;
+    }
+
+    /** Query properties and store them in the information structure. */
+    static query_status init_props(const connection& conn, gpuinfo& info) {
+        unused(conn);
+        unused(info);
+        return query_status::unsupported_version;
+    }
+};
+
+/** Pre-r21 JM kernel backend. */
+template <>
+struct backend<backend_type::pre_r21, true> {
+    static bool probe(const connection& conn, bool& supported) {
+        kbase_pre_r21::version_check_t pre_r21 {};
+        pre_r21.header.id = kbase_pre_r21::header_id::version_check;
+        conn.ioctl(kbase_pre_r21::version_check, &pre_r21);
+        // If this is non-zero this must be pre-r21 driver, so check version
+        if (pre_r21.is_set()) {
+            supported = is_supported(pre_r21.major, pre_r21.minor);
+            return true;
+        }
+
+        return false;
+    }
+
+    static bool set_flags(const connection& conn) {
+        // Clear errno
+        errno = 0;
+
+        kbase_pre_r21::set_flags_t flags {};
+        flags.header.id = kbase_pre_r21::header_id::set_flags;
+        flags.create_flags = system_monitor_flag;
+        conn.ioctl(kbase_pre_r21::set_flags, &flags);
+
+        return is_set_flags_success();
+    }
+
+    /** Get device constants from the old format ioctl. */
+    static query_status init_props(const connection& conn, gpuinfo& info) {
+        kbase_pre_r21::uk_gpuprops_t props {};
+        props.header.id = kbase_pre_r21::header_id::get_props;
+        errno = 0;
+        conn.ioctl(kbase_pre_r21::get_gpuprops, &props);
+        if (errno) {
+            return query_status::get_props_failed;
+        }
+
+        decode_pre_r21_props(props, info);
+        info.queues.scheduler = scheduler_type::job_manager;
+        return query_status::success;
+    }
+};
+
+/** Common implementation of the post-r21 JM and CSF kernel backends. */
+struct backend_post_r21 {
+    /** Size of the on-stack property buffer, sufficient for all known drivers. */
+    static constexpr std::size_t prop_buffer_size { 4096 };
+
+    /**
+     * Maximum size of the property buffer. Current drivers need less than
+     * 1KB, so anything larger than this is treated as a driver error rather
+     * than allocated.
+     */
+    static constexpr int max_prop_buffer_size { 64 * 1024 };
+
+    static bool set_flags(const connection& conn) {
+        // Clear errno
+        errno = 0;
+
+        kbase_post_r21::set_flags_t flags { system_monitor_flag };
+        conn.ioctl(kbase_post_r21::set_flags, &flags);
+
+        return is_set_flags_success();
+    }
+
+    /** Get device constants from the new format ioctl. */
+    static query_status init_props(const connection& conn, gpuinfo& info) {
+        errno = 0;
+
+        kbase_post_r21::get_gpuprops_t get_props = {};
+        int size = conn.ioctl(kbase_post_r21::get_gpuprops, &get_props);
+        if (errno || (size <= 0) || (size > max_prop_buffer_size)) {
+            return query_status::get_props_failed;
+        }
+
+        // Use the stack buffer unless the driver needs more space
+        unsigned char stack_buffer[prop_buffer_size];
+        std::unique_ptr<unsigned char[]> heap_buffer;
+        unsigned char* buffer = stack_buffer;
+
+        if (static_cast<std::size_t>(size) > prop_buffer_size) {
+            heap_buffer.reset(new (std::nothrow) unsigned char[size]);
+            if (!heap_buffer) {
+                return query_status::out_of_memory;
+            }
+
+            buffer = heap_buffer.get();
+        }
+
+        get_props.size = static_cast<uint32_t>(size);
+        get_props.buffer.reset(buffer);
+        int used = conn.ioctl(kbase_post_r21::get_gpuprops, &get_props);
+        if (errno || (used < 0) || (used > size)) {
+            return query_status::get_props_failed;
+        }
+
+        prop_decoder decoder { buffer, static_cast<std::size_t>(used) };
+        if (!decoder.decode(info)) {
+            return query_status::decode_failed;
+        }
+
+        return query_status::success;
+    }
+};
+
+/** Post-r21 JM kernel backend. */
+template <>
+struct backend<backend_type::post_r21_jm, true> : backend_post_r21 {
+    static bool probe(const connection& conn, bool& supported) {
+        kbase_post_r21::version_check_t post_r21 {};
+        conn.ioctl(kbase_post_r21::version_check_jm, &post_r21);
+        // If this is non-zero this must be post-r21 JM driver, so check version
+        if (post_r21.is_set()) {
+            supported = is_supported(post_r21.major, post_r21.minor);
+            return true;
+        }
+
+        return false;
+    }
+
+    static query_status init_props(const connection& conn, gpuinfo& info) {
+        query_status status = backend_post_r21::init_props(conn, info);
+        info.queues.scheduler = scheduler_type::job_manager;
+        return status;
+    }
+};
+
+/** Post-r21 CSF kernel backend. */
+template <>
+struct backend<backend_type::post_r21_csf, true> : backend_post_r21 {
+    static bool probe(const connection& conn, bool& supported) {
+        kbase_post_r21::version_check_t post_r21 {};
+        conn.ioctl(kbase_post_r21::version_check_csf, &post_r21);
+        // If this is any non-zero value this is a valid CSF GPU
+        supported = post_r21.is_set();
+        return supported;
+    }
+
+    static query_status init_props(const connection& conn, gpuinfo& info) {
+        query_status status = backend_post_r21::init_props(conn, info);
+        if (status != query_status::success) {
+            return status;
+        }
+
+        info.queues.scheduler = scheduler_type::csf;
+        init_queue_groups(conn, info);
+        return query_status::success;
+    }
+
+    /**
+     * Get the queue groups from the CSF firmware interface.
+     *
+     * The queue groups are not essential information, so if the query fails
+     * they are left unknown rather than failing the whole query.
+     */
+    static void init_queue_groups(const connection& conn, gpuinfo& info) {
+        kbase_post_r21::cs_group_control_t groups[kbase_post_r21::max_supported_csgs] {};
+
+        kbase_post_r21::cs_get_glb_iface_t iface {};
+        iface.in.max_group_num = kbase_post_r21::max_supported_csgs;
+        iface.in.groups_ptr.reset(groups);
+
+        errno = 0;
+        if ((conn.ioctl(kbase_post_r21::cs_get_glb_iface, &iface) < 0) || errno) {
+            return;
+        }
+
+        uint32_t num_groups = iface.out.group_num;
+        if (num_groups > kbase_post_r21::max_supported_csgs) {
+            num_groups = kbase_post_r21::max_supported_csgs;
+        }
+
+        uint32_t num_queues = num_groups ? groups[0].stream_num : 0;
+        for (uint32_t i = 1; i < num_groups; i++) {
+            if (groups[i].stream_num < num_queues) {
+                num_queues = groups[i].stream_num;
+            }
+        }
+
+        info.queues.csf_interface_version = iface.out.glb_version;
+        info.queues.num_queue_groups = num_groups;
+        info.queues.num_queues_per_group = num_queues;
+    }
+};
+
+/**
+ * Ordered list of kernel driver backends to probe.
+ *
+ * The pre-r21 backend must be first in the list because CSF reuses an old
+ * IOCTL ID.
+ */
+template <backend_type... types>
+struct backend_list;
+
+template <>
+struct backend_list<> {
+    static bool probe(const connection& conn, backend_type& type, bool& supported) {
+        unused(conn);
+        unused(type);
+        unused(supported);
+        return false;
+    }
+
+    static bool set_flags(const connection& conn, backend_type type) {
+        unused(conn);
+        unused(type);
+        return false;
+    }
+
+    static query_status init_props(const connection& conn, backend_type type, gpuinfo& info) {
+        unused(conn);
+        unused(type);
+        unused(info);
+        return query_status::unsupported_version;
+    }
+};
+
+template <backend_type first, backend_type... rest>
+struct backend_list<first, rest...> {
+    static bool probe(const connection& conn, backend_type& type, bool& supported) {
+        if (backend<first>::probe(conn, supported)) {
+            type = first;
+            return true;
+        }
+
+        return backend_list<rest...>::probe(conn, type, supported);
+    }
+
+    static bool set_flags(const connection& conn, backend_type type) {
+        if (is_backend_enabled(first) && (type == first)) {
+            return backend<first>::set_flags(conn);
+        }
+
+        return backend_list<rest...>::set_flags(conn, type);
+    }
+
+    static query_status init_props(const connection& conn, backend_type type, gpuinfo& info) {
+        if (is_backend_enabled(first) && (type == first)) {
+            return backend<first>::init_props(conn, info);
+        }
+
+        return backend_list<rest...>::init_props(conn, type, info);
+    }
+};
+
+/** The kernel driver backends, in probe order. */
+using backends = backend_list<
+    backend_type::pre_r21,
+    backend_type::post_r21_jm,
+    backend_type::post_r21_csf>;
+
+/**
+ * Kernel driver connection used to query the device properties.
+ *
+ * The connection does not own the file descriptor, and does not allocate
+ * memory unless the driver returns an unusually large property set.
+ */
+class kbase_device {
+  public:
+    /**
+     * Create a new connection.
+     *
+     * @param driver   The kernel driver system call interface.
+     * @param fd       The opened driver file descriptor.
+     */
+    kbase_device(const driver_interface& driver, int fd)
+        : conn_{ driver, fd } {}
+
+    /**
+     * Query the device properties.
+     *
+     * @param info   The returned device property information.
+     *
+     * @return The query status.
+     */
+    query_status query(gpuinfo& info) {
+        if (!check_version()) {
+            return query_status::unsupported_version;
+        }
+
+        if (!backends::set_flags(conn_, backend_)) {
+            return query_status::set_flags_failed;
+        }
+
+        return init_props(info);
+    }
+
+  private:
+    /** Check the Mali kernel driver interface version. */
+    bool check_version() {
+        bool supported { false };
+        if (!backends::probe(conn_, backend_, supported)) {
+            return false;
+        }
+
+        return supported;
+    }
+
+    /** Query properties and store them in the information structure. */
+    query_status init_props(gpuinfo& info) {
+        query_status status = backends::init_props(conn_, backend_, info);
+
+        // Perform some common cleanup on the data
+        if (status != query_status::success)
+        {
+            return status;
+        }
+
+        finalize_info(info);
+        return query_status::success;
+    }
+
+    /** The kernel driver connection. */
+    connection conn_;
+
+    /** The detected kernel driver backend. */
+    backend_type backend_ {};
+};
+
+}
+}
@@ -0,0 +1,818 @@
+/*
+ * Copyright (c) 2021-2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief The libGPUInfo library implementation.
+ *
+ * This header is compiled into the library by libgpuinfo.cpp, or is included
+ * by libgpuinfo.hpp when LIBGPUINFO_HEADER_ONLY is defined. Functions with
+ * external linkage are declared LIBGPUINFO_INLINE so that they can be defined
+ * in multiple translation units when used in header-only mode.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+#include "libgpuinfo.hpp"
+#include "libgpuinfo_capture.hpp"
+#include "libgpuinfo_decoder.hpp"
+#include "libgpuinfo_device.hpp"
+#include "libgpuinfo_products.hpp"
+
+namespace libarmgpuinfo {
+namespace detail {
+
+/**
+ * Get the L2 footprint of a block of tiles.
+ *
+ * @param working_set   The working set description.
+ * @param line_bytes    The L2 cache line size, in bytes.
+ * @param tiles_x       The number of tiles per block horizontally.
+ * @param tiles_y       The number of tiles per block vertically.
+ *
+ * @return The footprint in bytes, with each row rounded up to cache lines.
+ */
+constexpr uint64_t get_block_bytes(
+    const l2_working_set& working_set,
+    uint64_t line_bytes,
+    uint64_t tiles_x,
+    uint64_t tiles_y
+) {
+    const uint64_t row_bytes = tiles_x * working_set.tile_width * working_set.bytes_per_texel;
+    const uint64_t row_lines = (row_bytes + line_bytes - 1) / line_bytes;
+    return row_lines * line_bytes * tiles_y * working_set.tile_height;
+}
+
+/**
+ * Get the minimum cycles to process work at a peak rate.
+ *
+ * @param count    The amount of work.
+ * @param per_cy   The peak rate per clock, or zero if unknown.
+ *
+ * @return The cycles, rounded up, or zero if the rate is unknown.
+ */
+constexpr uint64_t get_unit_cycles(
+    uint64_t count,
+    uint64_t per_cy
+) {
+    return per_cy ? ((count / per_cy) + ((count % per_cy) ? 1 : 0)) : 0;
+}
+
+/**
+ * Estimate the throughput of a machine learning operator.
+ *
+ * @param info       The GPU information.
+ * @param type       The data type.
+ * @param num_macs   The number of multiply-accumulates.
+ * @param num_bytes  The minimum external memory traffic, in bytes.
+ *
+ * @return The estimated throughput.
+ */
+constexpr ml_estimate get_ml_estimate(
+    const gpuinfo& info,
+    ml_data_type type,
+    uint64_t num_macs,
+    uint64_t num_bytes
+) {
+    ml_estimate estimate {};
+    estimate.num_macs = num_macs;
+    estimate.num_bytes = num_bytes;
+
+    const uint64_t macs_per_core = (type == ml_data_type::int8) ? info.num_int8_macs_per_cy : info.num_fp16_macs_per_cy;
+    const uint64_t macs_per_cy = macs_per_core * info.num_shader_cores;
+    if (!macs_per_cy) {
+        return estimate;
+    }
+
+    const uint64_t bus_bytes_per_cy = (uint64_t { info.num_bus_bits } / 8) * info.num_l2_slices;
+
+    estimate.num_compute_cycles = get_unit_cycles(num_macs, macs_per_cy);
+    estimate.num_memory_cycles = get_unit_cycles(num_bytes, bus_bytes_per_cy);
+    estimate.num_cycles = (estimate.num_compute_cycles > estimate.num_memory_cycles) ?
+        estimate.num_compute_cycles : estimate.num_memory_cycles;
+    estimate.num_macs_per_cy = estimate.num_cycles ? (num_macs / estimate.num_cycles) : 0;
+    return estimate;
+}
+
+/** Number of configurations resolved against the catalog at a time. */
+constexpr std::size_t batch_tile_size { 256 };
+
+/**
+ * Resolve a tile of product configurations against the catalog.
+ *
+ * Each catalog entry is tested against every configuration in turn, in
+ * reverse catalog order so that the first match wins, using branchless
+ * selects that the compiler can vectorize.
+ *
+ * @param product_ids   The product IDs.
+ * @param core_counts   The shader core counts.
+ * @param count         The number of configurations, at most batch_tile_size.
+ * @param gpu_ids       The returned normalized product IDs.
+ * @param entries       The returned catalog indices matching the ID and core
+ *                      count, or num_product_versions if unknown.
+ * @param products      The returned catalog indices matching the ID only, or
+ *                      num_product_versions if unknown.
+ */
+inline void resolve_catalog_entries(
+    const uint32_t* product_ids,
+    const uint32_t* core_counts,
+    std::size_t count,
+    uint32_t* gpu_ids,
+    uint32_t* entries,
+    uint32_t* products
+) {
+    for (std::size_t i = 0; i < count; i++) {
+        gpu_ids[i] = product_ids[i];
+        entries[i] = num_product_versions;
+        products[i] = num_product_versions;
+    }
+
+    for (uint32_t e = num_product_versions; e-- > 0;) {
+        const product_entry& entry = PRODUCT_VERSIONS[e];
+        for (std::size_t i = 0; i < count; i++) {
+            gpu_ids[i] = ((product_ids[i] & entry.mask) == entry.id) ? entry.id : gpu_ids[i];
+        }
+    }
+
+    for (uint32_t e = num_product_versions; e-- > 0;) {
+        const product_entry& entry = PRODUCT_VERSIONS[e];
+        for (std::size_t i = 0; i < count; i++) {
+            const bool is_product = gpu_ids[i] == entry.id;
+            products[i] = is_product ? e : products[i];
+            entries[i] = (is_product && (core_counts[i] >= entry.min_cores)) ? e : entries[i];
+        }
+    }
+}
+
+/**
+ * Store a value in a row of a result column.
+ *
+ * @param column   The result column, or @c nullptr.
+ * @param row      The row index.
+ * @param value    The value.
+ */
+template <typename T, typename V>
+inline void store_column(
+    T* column,
+    std::size_t row,
+    V value
+) {
+    if (column) {
+        column[row] = value;
+    }
+}
+
+/**
+ * Store GPU information in a row of the result columns.
+ *
+ * @param info      The GPU information.
+ * @param row       The row index.
+ * @param results   The result columns.
+ */
+inline void store_columns(
+    const gpuinfo& info,
+    std::size_t row,
+    const gpuinfo_columns& results
+) {
+    store_column(results.gpu_id, row, info.gpu_id);
+    store_column(results.gpu_name, row, info.gpu_name);
+    store_column(results.architecture_name, row, info.architecture_name);
+    store_column(results.architecture_major, row, info.architecture_major);
+    store_column(results.architecture_minor, row, info.architecture_minor);
+    store_column(results.num_shader_cores, row, info.num_shader_cores);
+    store_column(results.shader_core_mask, row, info.shader_core_mask);
+    store_column(results.num_l2_slices, row, info.num_l2_slices);
+    store_column(results.num_l2_bytes, row, info.num_l2_bytes);
+    store_column(results.num_bus_bits, row, info.num_bus_bits);
+    store_column(results.num_exec_engines, row, info.num_exec_engines);
+    store_column(results.num_fp32_fmas_per_cy, row, info.num_fp32_fmas_per_cy);
+    store_column(results.num_fp16_fmas_per_cy, row, info.num_fp16_fmas_per_cy);
+    store_column(results.num_int8_macs_per_cy, row, info.num_int8_macs_per_cy);
+    store_column(results.num_fp16_macs_per_cy, row, info.num_fp16_macs_per_cy);
+    store_column(results.num_texels_per_cy, row, info.num_texels_per_cy);
+    store_column(results.num_pixels_per_cy, row, info.num_pixels_per_cy);
+    store_column(results.num_tiler_prims_per_cy, row, info.tiler.num_prims_per_cy);
+    store_column(results.num_threads_per_core, row, info.num_threads_per_core);
+}
+
+/**
+ * Gather a catalog column into a result column.
+ *
+ * @param table     The catalog column.
+ * @param indices   The catalog index of each row.
+ * @param count     The number of rows.
+ * @param column    The result column, or @c nullptr.
+ * @param base      The result row of the first index.
+ */
+template <typename T>
+inline void gather_column(
+    const T* table,
+    const uint32_t* indices,
+    std::size_t count,
+    T* column,
+    std::size_t base
+) {
+    if (!column) {
+        return;
+    }
+
+    for (std::size_t i = 0; i < count; i++) {
+        column[base + i] = table[indices[i]];
+    }
+}
+
+}
+
+/* See header for documentation */
+LIBGPUINFO_CONSTEXPR gpuinfo get_product_info(
+    uint32_t product_id,
+    uint32_t num_shader_cores,
+    uint32_t core_features,
+    uint32_t thread_features
+) {
+    gpuinfo info {};
+
+    info.gpu_id = detail::get_gpu_id(product_id);
+    info.gpu_name = detail::get_gpu_name(info.gpu_id, num_shader_cores);
+    info.architecture_name = detail::get_architecture_name(info.gpu_id);
+
+    detail::get_architecture_version(
+        info.gpu_id,
+        product_id << 16,
+        info.architecture_major,
+        info.architecture_minor);
+
+    info.num_shader_cores = num_shader_cores;
+    info.shader_core_mask = (num_shader_cores < 64) ? ((1ULL << num_shader_cores) - 1) : ~0ULL;
+    info.topology = make_core_topology(info.shader_core_mask);
+
+    info.num_exec_engines = detail::get_num_exec_engines(
+        info.gpu_id,
+        num_shader_cores,
+        core_features,
+        thread_features);
+
+    info.num_fp32_fmas_per_cy = detail::get_num_fp32_fmas(
+        info.gpu_id,
+        num_shader_cores,
+        core_features,
+        thread_features);
+
+    info.num_fp16_fmas_per_cy = info.num_fp32_fmas_per_cy * 2;
+
+    info.num_int8_macs_per_cy = detail::get_num_int8_macs(
+        info.gpu_id,
+        num_shader_cores,
+        core_features,
+        thread_features);
+
+    info.num_fp16_macs_per_cy = detail::get_num_fp16_macs(
+        info.gpu_id,
+        num_shader_cores,
+        core_features,
+        thread_features);
+
+    info.num_texels_per_cy = detail::get_num_texels(
+        info.gpu_id,
+        num_shader_cores,
+        core_features,
+        thread_features);
+
+    info.num_pixels_per_cy = detail::get_num_pixels(
+        info.gpu_id,
+        num_shader_cores,
+        core_features,
+        thread_features);
+
+    info.tiler.num_prims_per_cy = detail::get_num_tiler_prims(info.gpu_id);
+    info.num_threads_per_core = detail::get_num_threads(info.gpu_id);
+
+    return info;
+}
+
+/* See header for documentation */
+LIBGPUINFO_CONSTEXPR l2_blocking get_l2_blocking(
+    const gpuinfo& info,
+    const l2_working_set& working_set
+) {
+    l2_blocking result {};
+
+    const uint64_t line = info.num_l2_line_bytes;
+    if (!info.num_l2_bytes || !line || !working_set.tile_width ||
+        !working_set.tile_height || !working_set.bytes_per_texel) {
+        return result;
+    }
+
+    uint64_t num_cores = working_set.num_concurrent_cores;
+    if (!num_cores || (num_cores > info.num_shader_cores)) {
+        num_cores = info.num_shader_cores ? info.num_shader_cores : 1;
+    }
+
+    // Leave half of the cache for other traffic, and share the rest
+    const uint64_t budget = info.num_l2_bytes / 2;
+    const uint64_t core_budget = budget / num_cores;
+
+    if (detail::get_block_bytes(working_set, line, 1, 1) > core_budget) {
+        return result;
+    }
+
+    // Grow the block alternately in each dimension, widening first because
+    // rows are contiguous in memory
+    uint64_t tiles_x { 1 };
+    uint64_t tiles_y { 1 };
+    bool grow_x { true };
+    bool grew { true };
+    while (grew) {
+        grew = false;
+        for (int attempt = 0; attempt < 2; attempt++) {
+            const uint64_t next_x = grow_x ? tiles_x * 2 : tiles_x;
+            const uint64_t next_y = grow_x ? tiles_y : tiles_y * 2;
+            grow_x = !grow_x;
+            if (detail::get_block_bytes(working_set, line, next_x, next_y) <= core_budget) {
+                tiles_x = next_x;
+                tiles_y = next_y;
+                grew = true;
+                break;
+            }
+        }
+    }
+
+    result.tiles_x = static_cast<uint32_t>(tiles_x);
+    result.tiles_y = static_cast<uint32_t>(tiles_y);
+    result.block_bytes = static_cast<uint32_t>(
+        detail::get_block_bytes(working_set, line, tiles_x, tiles_y));
+
+    // Atlas pages are sampled by every core, so use the whole shared budget
+    uint64_t page { 1 };
+    while ((page * 2 * page * 2 * working_set.bytes_per_texel) <= budget) {
+        page *= 2;
+    }
+
+    result.atlas_page_texels = static_cast<uint32_t>(page);
+    return result;
+}
+
+/* See header for documentation */
+LIBGPUINFO_CONSTEXPR texture_format_ranking get_texture_format_ranking(
+    const gpuinfo& info,
+    texture_content content
+) {
+    // Candidates for each content class, fastest first. ASTC supports the
+    // lowest bit rates, down to 0.89 bits per texel for 2D blocks, and ETC2,
+    // EAC, and BC formats use 4 or 8 bits per texel.
+    texture_format candidates[max_ranked_texture_formats] {};
+    uint32_t num_candidates { 0 };
+
+    switch (content) {
+    case texture_content::color_rgb:
+        candidates[num_candidates++] = texture_format::astc_ldr;
+        candidates[num_candidates++] = texture_format::etc2;
+        candidates[num_candidates++] = texture_format::bc1;
+        candidates[num_candidates++] = texture_format::bc7;
+        break;
+    case texture_content::color_rgba:
+        candidates[num_candidates++] = texture_format::astc_ldr;
+        candidates[num_candidates++] = texture_format::etc2;
+        candidates[num_candidates++] = texture_format::bc7;
+        candidates[num_candidates++] = texture_format::bc3;
+        break;
+    case texture_content::normal_map:
+        candidates[num_candidates++] = texture_format::astc_ldr;
+        candidates[num_candidates++] = texture_format::eac;
+        candidates[num_candidates++] = texture_format::bc5;
+        break;
+    case texture_content::single_channel:
+        candidates[num_candidates++] = texture_format::astc_ldr;
+        candidates[num_candidates++] = texture_format::eac;
+        candidates[num_candidates++] = texture_format::bc4;
+        break;
+    case texture_content::hdr_color:
+        candidates[num_candidates++] = texture_format::astc_hdr;
+        candidates[num_candidates++] = texture_format::bc6h;
+        break;
+    case texture_content::volume:
+        candidates[num_candidates++] = texture_format::astc_3d_ldr;
+        break;
+    }
+
+    texture_format_ranking ranking {};
+    for (uint32_t i = 0; i < num_candidates; i++) {
+        if (has_texture_format(info, candidates[i])) {
+            ranking.formats[ranking.num_formats++] = candidates[i];
+        }
+    }
+
+    return ranking;
+}
+
+/* See header for documentation */
+LIBGPUINFO_CONSTEXPR memory_pool_sizing get_memory_pool_sizing(
+    const gpuinfo& info,
+    uint64_t requested_bytes
+) {
+    constexpr uint64_t large_page_bytes { 2 * 1024 * 1024 };
+    constexpr uint64_t small_chunk_bytes { 64 * 1024 };
+    constexpr uint64_t sparse_page_bytes { 64 * 1024 };
+
+    memory_pool_sizing sizing {};
+    if (!info.num_gpu_memory_bytes || !info.num_va_bits || (info.num_va_bits > 64)) {
+        return sizing;
+    }
+
+    // Leave half of the memory for the rest of the system
+    uint64_t pool_bytes = requested_bytes;
+    const uint64_t budget = info.num_gpu_memory_bytes / 2;
+    if (pool_bytes > budget) {
+        pool_bytes = budget;
+    }
+
+    const uint64_t chunk_bytes = (pool_bytes >= large_page_bytes) ? large_page_bytes : small_chunk_bytes;
+    uint64_t num_chunks = (pool_bytes + chunk_bytes - 1) / chunk_bytes;
+
+    // Rounding up must not exceed the budget
+    if ((num_chunks * chunk_bytes) > budget) {
+        num_chunks = budget / chunk_bytes;
+    }
+
+    sizing.chunk_bytes = chunk_bytes;
+    sizing.num_chunks = num_chunks;
+    sizing.pool_bytes = num_chunks * chunk_bytes;
+    sizing.sparse_page_bytes = sparse_page_bytes;
+    sizing.max_sparse_bytes = (info.num_va_bits >= 2) ? (1ULL << (info.num_va_bits - 2)) : 0;
+    return sizing;
+}
+
+/* See header for documentation */
+LIBGPUINFO_CONSTEXPR tiler_cost get_tiler_cost(
+    const gpuinfo& info,
+    uint64_t num_primitives,
+    uint32_t num_varying_bytes
+) {
+    constexpr uint64_t position_bytes { 16 };
+    constexpr uint64_t polygon_list_entry_bytes { 8 };
+
+    tiler_cost cost {};
+    if (!num_primitives) {
+        return cost;
+    }
+
+    uint64_t polygon_list_bytes = num_primitives * polygon_list_entry_bytes;
+
+    // The heap grows in whole bins, and each active level uses at least one
+    const uint64_t bin_bytes = info.tiler.bin_size_bytes;
+    if (bin_bytes) {
+        uint64_t num_bins = (polygon_list_bytes + bin_bytes - 1) / bin_bytes;
+        if (num_bins < info.tiler.max_active_levels) {
+            num_bins = info.tiler.max_active_levels;
+        }
+
+        polygon_list_bytes = num_bins * bin_bytes;
+    }
+
+    const uint64_t prims_per_cy = info.tiler.num_prims_per_cy;
+
+    cost.polygon_list_bytes = polygon_list_bytes;
+    cost.vertex_bytes = num_primitives * (position_bytes + num_varying_bytes);
+    cost.total_bytes = cost.polygon_list_bytes + cost.vertex_bytes;
+    cost.num_cycles = prims_per_cy ? (num_primitives + prims_per_cy - 1) / prims_per_cy : 0;
+    return cost;
+}
+
+/* See header for documentation */
+LIBGPUINFO_CONSTEXPR shader_occupancy get_shader_occupancy(
+    const gpuinfo& info,
+    const shader_resources& resources
+) {
+    shader_occupancy occupancy {};
+
+    const detail::register_rules* rules = detail::get_register_rules(info.architecture_major);
+    const uint32_t max_threads = info.num_threads_per_core;
+    if (!rules || !max_threads || (resources.num_work_registers > rules->max_work_registers)) {
+        return occupancy;
+    }
+
+    // Find the allocation step, which halves the threads each time
+    uint32_t allocated = rules->num_full_occupancy_registers;
+    uint32_t threads = max_threads;
+    while (allocated < resources.num_work_registers) {
+        allocated *= 2;
+        threads /= 2;
+    }
+
+    const uint32_t register_words = allocated * rules->num_register_words;
+    if (info.num_registers_per_core && ((info.num_registers_per_core / register_words) < threads)) {
+        threads = info.num_registers_per_core / register_words;
+    }
+
+    occupancy.num_threads = threads;
+    occupancy.occupancy_percent = static_cast<uint32_t>((uint64_t { threads } * 100) / max_threads);
+    occupancy.num_cliff_registers = allocated;
+    if (resources.num_uniform_registers > rules->num_uniform_registers) {
+        occupancy.num_spilled_uniform_registers = resources.num_uniform_registers - rules->num_uniform_registers;
+    }
+
+    occupancy.num_stack_bytes_per_core = uint64_t { threads } * resources.num_stack_bytes;
+    return occupancy;
+}
+
+/* See header for documentation */
+LIBGPUINFO_CONSTEXPR frame_bounds get_frame_bounds(
+    const gpuinfo& info,
+    const frame_workload& workload,
+    uint64_t clock_hz
+) {
+    constexpr uint64_t ns_per_s { 1000000000 };
+
+    frame_bounds bounds {};
+    const uint64_t cores = info.num_shader_cores;
+
+    // FP32 and FP16 FMAs issue to the same pipelines, so their times add
+    const uint64_t fp32_cycles = detail::get_unit_cycles(workload.num_fp32_fmas, cores * info.num_fp32_fmas_per_cy);
+    const uint64_t fp16_cycles = detail::get_unit_cycles(workload.num_fp16_fmas, cores * info.num_fp16_fmas_per_cy);
+    const uint64_t bus_bytes_per_cy = (uint64_t { info.num_bus_bits } / 8) * info.num_l2_slices;
+
+    uint64_t* cycles = bounds.num_cycles;
+    cycles[static_cast<uint32_t>(frame_unit::arithmetic)] = fp32_cycles + fp16_cycles;
+    cycles[static_cast<uint32_t>(frame_unit::texture)] =
+        detail::get_unit_cycles(workload.num_texels, cores * info.num_texels_per_cy);
+    cycles[static_cast<uint32_t>(frame_unit::pixel)] =
+        detail::get_unit_cycles(workload.num_pixels, cores * info.num_pixels_per_cy);
+    cycles[static_cast<uint32_t>(frame_unit::memory)] =
+        detail::get_unit_cycles(workload.num_read_bytes + workload.num_write_bytes, bus_bytes_per_cy);
+    cycles[static_cast<uint32_t>(frame_unit::tiler)] =
+        detail::get_unit_cycles(workload.num_primitives, info.tiler.num_prims_per_cy);
+
+    // The first unit with the longest time is the limiter
+    uint64_t limiter_cycles { 0 };
+    for (uint32_t i = 1; i < num_frame_units; i++) {
+        if (cycles[i] > limiter_cycles) {
+            limiter_cycles = cycles[i];
+            bounds.limiter = static_cast<frame_unit>(i);
+        }
+
+        // Split the conversion so that it cannot overflow for any realistic clock
+        if (clock_hz) {
+            bounds.num_ns[i] = ((cycles[i] / clock_hz) * ns_per_s) + (((cycles[i] % clock_hz) * ns_per_s) / clock_hz);
+        }
+    }
+
+    return bounds;
+}
+
+/* See header for documentation */
+LIBGPUINFO_CONSTEXPR ml_estimate get_gemm_estimate(
+    const gpuinfo& info,
+    const gemm_shape& shape,
+    ml_data_type type
+) {
+    const uint64_t element_bytes = (type == ml_data_type::int8) ? 1 : 2;
+    const uint64_t num_elements = (shape.m * shape.k) + (shape.k * shape.n) + (shape.m * shape.n);
+    return detail::get_ml_estimate(info, type, shape.m * shape.n * shape.k, num_elements * element_bytes);
+}
+
+/* See header for documentation */
+LIBGPUINFO_CONSTEXPR ml_estimate get_conv_estimate(
+    const gpuinfo& info,
+    const conv_shape& shape,
+    ml_data_type type
+) {
+    const uint64_t element_bytes = (type == ml_data_type::int8) ? 1 : 2;
+    const uint64_t stride = shape.stride ? shape.stride : 1;
+
+    // Implicit matrix multiplication of output pixels by filter taps
+    const uint64_t out_pixels = shape.batch * shape.out_height * shape.out_width;
+    const uint64_t taps = shape.in_channels * shape.kernel_height * shape.kernel_width;
+
+    const uint64_t in_elements = out_pixels * stride * stride * shape.in_channels;
+    const uint64_t weight_elements = taps * shape.out_channels;
+    const uint64_t out_elements = out_pixels * shape.out_channels;
+    const uint64_t num_bytes = (in_elements + weight_elements + out_elements) * element_bytes;
+
+    return detail::get_ml_estimate(info, type, out_pixels * taps * shape.out_channels, num_bytes);
+}
+
+/* See header for documentation */
+LIBGPUINFO_INLINE bool decode_capture(
+    const void* data,
+    std::size_t size,
+    gpuinfo& info
+) {
+    detail::capture_view capture {};
+    if (!detail::parse_capture(static_cast<const unsigned char*>(data), size, capture)) {
+        return false;
+    }
+
+    gpuinfo result {};
+    if (capture.kernel == detail::capture_kernel::pre_r21) {
+        kbase_pre_r21::uk_gpuprops_t props {};
+        detail::pre_r21_reader reader { capture.payload, capture.payload_size };
+        if (!reader.read(props)) {
+            return false;
+        }
+
+        detail::decode_pre_r21_props(props, result);
+        result.queues.scheduler = scheduler_type::job_manager;
+    } else {
+        detail::prop_decoder decoder { capture.payload, capture.payload_size };
+        if (!decoder.decode(result)) {
+            return false;
+        }
+
+        // Captures do not include the CSF firmware interface, so the queue
+        // groups are unknown
+        const bool is_csf = capture.kernel == detail::capture_kernel::post_r21_csf;
+        result.queues.scheduler = is_csf ? scheduler_type::csf : scheduler_type::job_manager;
+    }
+
+    detail::finalize_info(result);
+    info = result;
+    return true;
+}
+
+/* See header for documentation */
+LIBGPUINFO_INLINE void get_product_info_batch(
+    const product_config_columns& configs,
+    std::size_t count,
+    const gpuinfo_columns& results
+) {
+    using detail::CATALOG_COLUMNS;
+    using detail::gather_column;
+
+    constexpr std::size_t tile_size { detail::batch_tile_size };
+    uint32_t gpu_ids[tile_size];
+    uint32_t entries[tile_size];
+    uint32_t products[tile_size];
+
+    for (std::size_t base = 0; base < count; base += tile_size) {
+        const std::size_t n = ((count - base) < tile_size) ? (count - base) : tile_size;
+        const uint32_t* product_ids = configs.product_ids + base;
+        const uint32_t* core_counts = configs.num_shader_cores + base;
+
+        detail::resolve_catalog_entries(product_ids, core_counts, n, gpu_ids, entries, products);
+
+        // Values that are not in the catalog
+        for (std::size_t i = 0; i < n; i++) {
+            const uint64_t core_mask = (core_counts[i] < 64) ? ((1ULL << core_counts[i]) - 1) : ~0ULL;
+            detail::store_column(results.gpu_id, base + i, gpu_ids[i]);
+            detail::store_column(results.num_shader_cores, base + i, core_counts[i]);
+            detail::store_column(results.shader_core_mask, base + i, core_mask);
+            detail::store_column(results.num_l2_slices, base + i, 0);
+            detail::store_column(results.num_l2_bytes, base + i, 0);
+            detail::store_column(results.num_bus_bits, base + i, 0);
+        }
+
+        if (results.architecture_major || results.architecture_minor) {
+            for (std::size_t i = 0; i < n; i++) {
+                uint32_t major { 0 };
+                uint32_t minor { 0 };
+                detail::get_architecture_version(gpu_ids[i], product_ids[i] << 16, major, minor);
+                detail::store_column(results.architecture_major, base + i, major);
+                detail::store_column(results.architecture_minor, base + i, minor);
+            }
+        }
+
+        // Catalog values, gathered by catalog index
+        gather_column(CATALOG_COLUMNS.name, entries, n, results.gpu_name, base);
+        gather_column(CATALOG_COLUMNS.architecture, products, n, results.architecture_name, base);
+        gather_column(CATALOG_COLUMNS.num_exec_engines, entries, n, results.num_exec_engines, base);
+        gather_column(CATALOG_COLUMNS.num_fp32_fmas, entries, n, results.num_fp32_fmas_per_cy, base);
+        gather_column(CATALOG_COLUMNS.num_int8_macs, entries, n, results.num_int8_macs_per_cy, base);
+        gather_column(CATALOG_COLUMNS.num_fp16_macs, entries, n, results.num_fp16_macs_per_cy, base);
+        gather_column(CATALOG_COLUMNS.num_texels, entries, n, results.num_texels_per_cy, base);
+        gather_column(CATALOG_COLUMNS.num_pixels, entries, n, results.num_pixels_per_cy, base);
+        gather_column(CATALOG_COLUMNS.num_tiler_prims, products, n, results.num_tiler_prims_per_cy, base);
+        gather_column(CATALOG_COLUMNS.num_threads, products, n, results.num_threads_per_core, base);
+
+        if (results.num_fp16_fmas_per_cy) {
+            for (std::size_t i = 0; i < n; i++) {
+                results.num_fp16_fmas_per_cy[base + i] = CATALOG_COLUMNS.num_fp32_fmas[entries[i]] * 2;
+            }
+        }
+
+        // Products whose rates depend on the core configuration
+        for (std::size_t i = 0; i < n; i++) {
+            if (!CATALOG_COLUMNS.is_variant[entries[i]]) {
+                continue;
+            }
+
+            const gpuinfo info = get_product_info(
+                product_ids[i],
+                core_counts[i],
+                configs.core_features ? configs.core_features[base + i] : 0,
+                configs.thread_features ? configs.thread_features[base + i] : 0);
+
+            detail::store_columns(info, base + i, results);
+        }
+    }
+}
+
+/* See header for documentation */
+LIBGPUINFO_INLINE std::size_t decode_capture_batch(
+    const void* const* captures,
+    const std::size_t* sizes,
+    std::size_t count,
+    const gpuinfo_columns& results,
+    bool* decoded
+) {
+    std::size_t num_decoded { 0 };
+    for (std::size_t i = 0; i < count; i++) {
+        gpuinfo info {};
+        const bool ok = decode_capture(captures[i], sizes[i], info);
+        detail::store_columns(ok ? info : gpuinfo {}, i, results);
+        if (decoded) {
+            decoded[i] = ok;
+        }
+
+        num_decoded += ok ? 1 : 0;
+    }
+
+    return num_decoded;
+}
+
+/* See header for documentation */
+LIBGPUINFO_INLINE std::unique_ptr<instance> instance::create(
+    const uint32_t id
+) {
+    return create(id, detail::system_driver);
+}
+
+/* See header for documentation */
+LIBGPUINFO_INLINE std::unique_ptr<instance> instance::create(
+    const uint32_t id,
+    const driver_interface& driver
+) {
+    int fd { -1 };
+    if (detail::open_device(driver, id, fd) != detail::query_status::success) {
+        return nullptr;
+    }
+
+    // Create the instance
+    auto result = std::unique_ptr<instance>(new (std::nothrow) instance(driver, fd));
+    if (!result || !result->valid_) {
+        driver.close(fd);
+        return nullptr;
+    }
+
+    // Nothing uses the connection after the query, so close it to release the
+    // kernel driver context rather than holding it for the instance lifetime
+    const int64_t used_bytes = detail::get_memory_usage(driver, id);
+    driver.close(fd);
+    const int64_t idle_bytes = detail::get_memory_usage(driver, id);
+
+    if ((used_bytes >= 0) && (idle_bytes >= 0) && (used_bytes > idle_bytes)) {
+        result->released_kernel_bytes_ = static_cast<uint64_t>(used_bytes - idle_bytes);
+    }
+
+    return result;
+}
+
+/* See header for documentation */
+LIBGPUINFO_INLINE const gpuinfo& instance::get_info() const
+{
+    return info_;
+}
+
+/* See header for documentation */
+LIBGPUINFO_INLINE uint64_t instance::get_released_kernel_bytes() const
+{
+    return released_kernel_bytes_;
+}
+
+/* See header for documentation */
+LIBGPUINFO_INLINE instance::~instance()
+{
+}
+
+/* See header for documentation */
+LIBGPUINFO_INLINE instance::instance(const driver_interface& driver, int fd)
+{
+    detail::kbase_device device { driver, fd };
+    valid_ = device.query(info_) == detail::query_status::success;
+}
+
+}
@@ -0,0 +1,738 @@
+/*
+ * Copyright (c) 2021-2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief The libGPUInfo product catalog.
+ *
+ * This header contains the table of known Arm GPU products, and the decoder
+ * functions used to determine the performance characteristics of each product
+ * and its configurable variants.
+ *
+ * All lookups are constexpr, so the compiler can fold them when the product
+ * configuration is known at compile time.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace libarmgpuinfo {
+namespace detail {
+
+/** Suppress unused parameter warnings. */
+template <typename... T>
+constexpr void unused(
+    const T&...
+) {
+}
+
+/** Per-product decoder for a configuration-dependent performance value. */
+using variant_decoder = uint32_t (*)(int, uint32_t, uint32_t);
+
+struct product_entry {
+    uint32_t id;
+    uint32_t mask;
+    uint32_t min_cores;
+    const char* name;
+    const char* architecture;
+    variant_decoder get_num_fp32_fmas_per_engine;
+    variant_decoder get_num_texels;
+    variant_decoder get_num_pixels;
+    variant_decoder get_num_exec_engines;
+    variant_decoder get_num_int8_macs_per_engine;
+    variant_decoder get_num_fp16_macs_per_engine;
+    uint32_t num_tiler_prims_per_cy;
+    uint32_t num_threads_per_core;
+};
+
+constexpr uint32_t MASK_OLD { 0xFFFF };
+constexpr uint32_t MASK_NEW { 0xF00F };
+
+template <uint32_t val>
+constexpr uint32_t get_num(
+    int core_count,
+    uint32_t core_features,
+    uint32_t thread_features
+) {
+    unused(core_count);
+    unused(core_features);
+    unused(thread_features);
+
+    return val;
+}
+
+constexpr uint32_t get_num_eng_g31(
+    int core_count,
+    uint32_t core_features,
+    uint32_t thread_features
+) {
+    unused(core_features);
+
+    if ((core_count == 1) && ((thread_features & 0xFFFF) == 0x2000))
+    {
+        return 1;
+    }
+
+    return 2;
+}
+
+constexpr uint32_t get_num_eng_g51(
+    int core_count,
+    uint32_t core_features,
+    uint32_t thread_features
+) {
+    unused(core_features);
+
+    if ((core_count == 1) && ((thread_features & 0xFFFF) == 0x2000))
+    {
+        return 1;
+    }
+
+    return 3;
+}
+
+constexpr uint32_t get_num_eng_g52(
+    int core_count,
+    uint32_t core_features,
+    uint32_t thread_features
+) {
+    unused(core_count);
+    unused(thread_features);
+
+    return core_features & 0xF;
+}
+
+constexpr uint32_t get_num_fma_g510(
+    int core_count,
+    uint32_t core_features,
+    uint32_t thread_features
+) {
+    unused(core_count);
+    unused(thread_features);
+
+    uint32_t variant = core_features & 0xF;
+    switch(variant)
+    {
+        case 0:
+            return 16;
+        case 2:
+        case 3:
+            return 24;
+        case 1:
+        case 4:
+        case 5:
+        case 6:
+        default:
+            return 32;
+    }
+}
+
+constexpr uint32_t get_num_tex_g510(
+    int core_count,
+    uint32_t core_features,
+    uint32_t thread_features
+) {
+    unused(core_count);
+    unused(thread_features);
+
+    uint32_t variant = core_features & 0xF;
+    switch(variant)
+    {
+        case 0:
+        case 5:
+            return 2;
+        case 1:
+        case 2:
+        case 6:
+            return 4;
+        case 3:
+        case 4:
+        default:
+            return 8;
+    }
+}
+
+constexpr uint32_t get_num_pix_g510(
+    int core_count,
+    uint32_t core_features,
+    uint32_t thread_features
+) {
+    unused(core_count);
+    unused(thread_features);
+
+    // This returns min(blend, pixel)
+    // Also limits to 2 for single engine configs
+    uint32_t variant = core_features & 0xF;
+    switch(variant)
+    {
+        case 0:
+        case 1:
+        case 5:
+        case 6:
+            return 2;
+        case 2:
+        case 3:
+        case 4:
+        default:
+            return 4;
+    }
+}
+
+constexpr uint32_t get_num_eng_g510(
+    int core_count,
+    uint32_t core_features,
+    uint32_t thread_features
+) {
+    unused(core_count);
+    unused(thread_features);
+
+    uint32_t variant = core_features & 0xF;
+    switch(variant)
+    {
+        case 0:
+        case 1:
+        case 5:
+        case 6:
+            return 1;
+        case 2:
+        case 3:
+        case 4:
+        default:
+            return 2;
+    }
+}
+
+constexpr uint32_t get_num_i8_g510(
+    int core_count,
+    uint32_t core_features,
+    uint32_t thread_features
+) {
+    // Each 32-bit FMA lane computes a four-way int8 dot product
+    return get_num_fma_g510(core_count, core_features, thread_features) * 4;
+}
+
+constexpr uint32_t get_num_f16_g510(
+    int core_count,
+    uint32_t core_features,
+    uint32_t thread_features
+) {
+    // Each 32-bit FMA lane computes a two-way fp16 dot product
+    return get_num_fma_g510(core_count, core_features, thread_features) * 2;
+}
+
+constexpr product_entry PRODUCT_VERSIONS[] {
+    //                  ID,  ID Mask, Min cores,              Name,           Arch,      FMA/Eng,           Texels,           Pixels,          Engines,    Int8 MAC/Eng,    FP16 MAC/Eng, Prims, Threads
+    product_entry { 0x6956, MASK_OLD,         1,       "Mali-T600",      "Midgard",       get_num<4>,       get_num<1>,       get_num<1>,       get_num<2>,      get_num<0>,      get_num<8>,     1,     256 },
+    product_entry { 0x0620, MASK_OLD,         1,       "Mali-T620",      "Midgard",       get_num<4>,       get_num<1>,       get_num<1>,       get_num<2>,      get_num<0>,      get_num<8>,     1,     256 },
+    product_entry { 0x0720, MASK_OLD,         1,       "Mali-T720",      "Midgard",       get_num<4>,       get_num<1>,       get_num<1>,       get_num<1>,      get_num<0>,      get_num<8>,     1,     256 },
+    product_entry { 0x0750, MASK_OLD,         1,       "Mali-T760",      "Midgard",       get_num<4>,       get_num<1>,       get_num<1>,       get_num<2>,      get_num<0>,      get_num<8>,     1,     256 },
+    product_entry { 0x0820, MASK_OLD,         1,       "Mali-T820",      "Midgard",       get_num<4>,       get_num<1>,       get_num<1>,       get_num<1>,      get_num<0>,      get_num<8>,     1,     256 },
+    product_entry { 0x0830, MASK_OLD,         1,       "Mali-T830",      "Midgard",       get_num<4>,       get_num<1>,       get_num<1>,       get_num<2>,      get_num<0>,      get_num<8>,     1,     256 },
+    product_entry { 0x0860, MASK_OLD,         1,       "Mali-T860",      "Midgard",       get_num<4>,       get_num<1>,       get_num<1>,       get_num<2>,      get_num<0>,      get_num<8>,     1,     256 },
+    product_entry { 0x0880, MASK_OLD,         1,       "Mali-T880",      "Midgard",       get_num<4>,       get_num<1>,       get_num<1>,       get_num<3>,      get_num<0>,      get_num<8>,     1,     256 },
+    product_entry { 0x6000, MASK_NEW,         1,        "Mali-G71",      "Bifrost",       get_num<4>,       get_num<1>,       get_num<1>,       get_num<3>,      get_num<0>,      get_num<8>,     1,     384 },
+    product_entry { 0x6001, MASK_NEW,         1,        "Mali-G72",      "Bifrost",       get_num<4>,       get_num<1>,       get_num<1>,       get_num<3>,      get_num<0>,      get_num<8>,     1,     384 },
+    product_entry { 0x7000, MASK_NEW,         1,        "Mali-G51",      "Bifrost",       get_num<4>,       get_num<2>,       get_num<2>,  get_num_eng_g51,      get_num<0>,      get_num<8>,     1,     768 },
+    product_entry { 0x7001, MASK_NEW,         1,        "Mali-G76",      "Bifrost",       get_num<8>,       get_num<2>,       get_num<2>,       get_num<3>,     get_num<32>,     get_num<16>,     1,     768 },
+    product_entry { 0x7002, MASK_NEW,         1,        "Mali-G52",      "Bifrost",       get_num<8>,       get_num<2>,       get_num<2>,  get_num_eng_g52,     get_num<32>,     get_num<16>,     1,     768 },
+    product_entry { 0x7003, MASK_NEW,         1,        "Mali-G31",      "Bifrost",       get_num<4>,       get_num<2>,       get_num<2>,  get_num_eng_g31,      get_num<0>,      get_num<8>,     1,     512 },
+    product_entry { 0x9000, MASK_NEW,         1,        "Mali-G77",      "Valhall",      get_num<16>,       get_num<4>,       get_num<2>,       get_num<2>,     get_num<64>,     get_num<32>,     1,    1024 },
+    product_entry { 0x9001, MASK_NEW,         1,        "Mali-G57",      "Valhall",      get_num<16>,       get_num<4>,       get_num<2>,       get_num<2>,     get_num<64>,     get_num<32>,     1,    1024 },
+    product_entry { 0x9003, MASK_NEW,         1,        "Mali-G57",      "Valhall",      get_num<16>,       get_num<4>,       get_num<2>,       get_num<2>,     get_num<64>,     get_num<32>,     1,    1024 },
+    product_entry { 0x9004, MASK_NEW,         1,        "Mali-G68",      "Valhall",      get_num<16>,       get_num<4>,       get_num<2>,       get_num<2>,     get_num<64>,     get_num<32>,     1,    1024 },
+    product_entry { 0x9002, MASK_NEW,         1,        "Mali-G78",      "Valhall",      get_num<16>,       get_num<4>,       get_num<2>,       get_num<2>,     get_num<64>,     get_num<32>,     1,    1024 },
+    product_entry { 0x9005, MASK_NEW,         1,      "Mali-G78AE",      "Valhall",      get_num<16>,       get_num<4>,       get_num<2>,       get_num<2>,     get_num<64>,     get_num<32>,     1,    1024 },
+    product_entry { 0xa002, MASK_NEW,         1,       "Mali-G710",      "Valhall",      get_num<32>,       get_num<8>,       get_num<4>,       get_num<2>,    get_num<128>,     get_num<64>,     2,    2048 },
+    product_entry { 0xa007, MASK_NEW,         1,       "Mali-G610",      "Valhall",      get_num<32>,       get_num<8>,       get_num<4>,       get_num<2>,    get_num<128>,     get_num<64>,     2,    2048 },
+    product_entry { 0xa003, MASK_NEW,         1,       "Mali-G510",      "Valhall", get_num_fma_g510, get_num_tex_g510, get_num_pix_g510, get_num_eng_g510, get_num_i8_g510, get_num_f16_g510,     2,    1024 },
+    product_entry { 0xa004, MASK_NEW,         1,       "Mali-G310",      "Valhall", get_num_fma_g510, get_num_tex_g510, get_num_pix_g510, get_num_eng_g510, get_num_i8_g510, get_num_f16_g510,     2,     512 },
+    product_entry { 0xb002, MASK_NEW,        10, "Immortalis-G715",      "Valhall",      get_num<64>,       get_num<8>,       get_num<4>,       get_num<2>,    get_num<256>,    get_num<128>,     2,    2048 },
+    product_entry { 0xb002, MASK_NEW,         7,       "Mali-G715",      "Valhall",      get_num<64>,       get_num<8>,       get_num<4>,       get_num<2>,    get_num<256>,    get_num<128>,     2,    2048 },
+    product_entry { 0xb002, MASK_NEW,         1,       "Mali-G615",      "Valhall",      get_num<64>,       get_num<8>,       get_num<4>,       get_num<2>,    get_num<256>,    get_num<128>,     2,    2048 },
+    product_entry { 0xb003, MASK_NEW,         1,       "Mali-G615",      "Valhall",      get_num<64>,       get_num<8>,       get_num<4>,       get_num<2>,    get_num<256>,    get_num<128>,     2,    2048 },
+    product_entry { 0xc000, MASK_NEW,        10, "Immortalis-G720", "Arm 5th Gen",      get_num<64>,       get_num<8>,       get_num<4>,       get_num<2>,    get_num<256>,    get_num<128>,     2,    2048 },
+    product_entry { 0xc000, MASK_NEW,         6,       "Mali-G720", "Arm 5th Gen",      get_num<64>,       get_num<8>,       get_num<4>,       get_num<2>,    get_num<256>,    get_num<128>,     2,    2048 },
+    product_entry { 0xc000, MASK_NEW,         1,       "Mali-G620", "Arm 5th Gen",      get_num<64>,       get_num<8>,       get_num<4>,       get_num<2>,    get_num<256>,    get_num<128>,     2,    2048 },
+    product_entry { 0xc001, MASK_NEW,         1,       "Mali-G620", "Arm 5th Gen",      get_num<64>,       get_num<8>,       get_num<4>,       get_num<2>,    get_num<256>,    get_num<128>,     2,    2048 },
+    product_entry { 0xd000, MASK_NEW,        10, "Immortalis-G925", "Arm 5th Gen",      get_num<64>,       get_num<8>,       get_num<4>,       get_num<2>,    get_num<256>,    get_num<128>,     2,    2048 },
+    product_entry { 0xd000, MASK_NEW,         6,       "Mali-G725", "Arm 5th Gen",      get_num<64>,       get_num<8>,       get_num<4>,       get_num<2>,    get_num<256>,    get_num<128>,     2,    2048 },
+    product_entry { 0xd001, MASK_NEW,         1,       "Mali-G625", "Arm 5th Gen",      get_num<64>,       get_num<8>,       get_num<4>,       get_num<2>,    get_num<256>,    get_num<128>,     2,    2048 },
+};
+
+constexpr uint32_t get_gpu_id(
+    uint32_t gpu_id
+) {
+    for (const auto& entry : PRODUCT_VERSIONS)
+    {
+        if (((gpu_id & entry.mask) == entry.id))
+        {
+            return entry.id;
+        }
+    }
+
+    return gpu_id;
+}
+
+constexpr const char* get_gpu_name(
+    uint32_t gpu_id,
+    uint32_t core_count
+) {
+    for (const auto& entry : PRODUCT_VERSIONS)
+    {
+        if((gpu_id == entry.id) && (core_count >= entry.min_cores))
+        {
+            return entry.name;
+        }
+    }
+
+    return "Unknown";
+}
+
+constexpr const char* get_architecture_name(
+    uint32_t gpu_id
+) {
+    for (const auto& entry : PRODUCT_VERSIONS)
+    {
+        if(gpu_id == entry.id)
+        {
+            return entry.architecture;
+        }
+    }
+
+    return "Unknown";
+}
+
+/**
+ * Get the architecture version for a 32-bit GPU ID.
+ *
+ * @param gpu_id       The product ID, after catalog normalization.
+ * @param raw_gpu_id   The raw 32-bit GPU_ID register value.
+ * @param major        The returned architecture major version.
+ * @param minor        The returned architecture minor version.
+ */
+constexpr void get_architecture_version(
+    uint32_t gpu_id,
+    uint32_t raw_gpu_id,
+    uint32_t& major,
+    uint32_t& minor
+) {
+    switch (gpu_id) {
+        // Midgard GPUs require manual specification, as not machine readable
+        case 0x6956: // Mali-T600
+            major = 4;
+            minor = 0;
+            break;
+        case 0x0620: // Mali-T620
+            major = 4;
+            minor = 1;
+            break;
+        case 0x0720: // Mali-T720
+            major = 4;
+            minor = 2;
+            break;
+        case 0x0750: // Mali-T760
+            major = 5;
+            minor = 0;
+            break;
+        case 0x0820: // Mali-T820
+        case 0x0830: // Mali-T830
+            major = 5;
+            minor = 1;
+            break;
+        case 0x0860: // Mali-T860
+        case 0x0880: // Mali-T880
+            major = 5;
+            minor = 2;
+            break;
+        // Bifrost onwards report architecture version via config register
+        default:
+        {
+            constexpr unsigned int arch_major_offset { 28 };
+            constexpr unsigned int arch_minor_offset { 24 };
+            constexpr unsigned int bits4 { 0xF };
+            major = (raw_gpu_id >> arch_major_offset) & bits4;
+            minor = (raw_gpu_id >> arch_minor_offset) & bits4;
+            break;
+        }
+    }
+}
+
+constexpr uint32_t get_num_exec_engines(
+    uint32_t gpu_id,
+    uint32_t core_count,
+    uint32_t core_features,
+    uint32_t thread_features
+) {
+    for (const auto& entry : PRODUCT_VERSIONS)
+    {
+        if((gpu_id == entry.id) && (core_count >= entry.min_cores))
+        {
+            return entry.get_num_exec_engines(core_count, core_features, thread_features);
+        }
+    }
+
+    return 0;
+}
+
+constexpr uint32_t get_num_fp32_fmas(
+    uint32_t gpu_id,
+    uint32_t core_count,
+    uint32_t core_features,
+    uint32_t thread_features
+) {
+    for (const auto& entry : PRODUCT_VERSIONS)
+    {
+        if((gpu_id == entry.id) && (core_count >= entry.min_cores))
+        {
+            return entry.get_num_fp32_fmas_per_engine(core_count, core_features, thread_features) *
+                   entry.get_num_exec_engines(core_count, core_features, thread_features);
+        }
+    }
+
+    return 0;
+}
+
+constexpr uint32_t get_num_int8_macs(
+    uint32_t gpu_id,
+    uint32_t core_count,
+    uint32_t core_features,
+    uint32_t thread_features
+) {
+    for (const auto& entry : PRODUCT_VERSIONS)
+    {
+        if((gpu_id == entry.id) && (core_count >= entry.min_cores))
+        {
+            return entry.get_num_int8_macs_per_engine(core_count, core_features, thread_features) *
+                   entry.get_num_exec_engines(core_count, core_features, thread_features);
+        }
+    }
+
+    return 0;
+}
+
+constexpr uint32_t get_num_fp16_macs(
+    uint32_t gpu_id,
+    uint32_t core_count,
+    uint32_t core_features,
+    uint32_t thread_features
+) {
+    for (const auto& entry : PRODUCT_VERSIONS)
+    {
+        if((gpu_id == entry.id) && (core_count >= entry.min_cores))
+        {
+            return entry.get_num_fp16_macs_per_engine(core_count, core_features, thread_features) *
+                   entry.get_num_exec_engines(core_count, core_features, thread_features);
+        }
+    }
+
+    return 0;
+}
+
+constexpr uint32_t get_num_texels(
+    uint32_t gpu_id,
+    uint32_t core_count,
+    uint32_t core_features,
+    uint32_t thread_features
+) {
+    for (const auto& entry : PRODUCT_VERSIONS)
+    {
+        if((gpu_id == entry.id) && (core_count >= entry.min_cores))
+        {
+            return entry.get_num_texels(core_count, core_features, thread_features);
+        }
+    }
+
+    return 0;
+}
+
+constexpr uint32_t get_num_pixels(
+    uint32_t gpu_id,
+    uint32_t core_count,
+    uint32_t core_features,
+    uint32_t thread_features
+) {
+    for (const auto& entry : PRODUCT_VERSIONS)
+    {
+        if((gpu_id == entry.id) && (core_count >= entry.min_cores))
+        {
+            return entry.get_num_pixels(core_count, core_features, thread_features);
+        }
+    }
+
+    return 0;
+}
+
+constexpr uint32_t get_num_tiler_prims(
+    uint32_t gpu_id
+) {
+    for (const auto& entry : PRODUCT_VERSIONS)
+    {
+        if (gpu_id == entry.id)
+        {
+            return entry.num_tiler_prims_per_cy;
+        }
+    }
+
+    return 0;
+}
+
+constexpr uint32_t get_num_threads(
+    uint32_t gpu_id
+) {
+    for (const auto& entry : PRODUCT_VERSIONS)
+    {
+        if (gpu_id == entry.id)
+        {
+            return entry.num_threads_per_core;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Per-architecture work register allocation rules.
+ *
+ * Threads allocate work registers in steps that start at the full occupancy
+ * register count and double up to the maximum, and each step halves the
+ * number of resident threads. Midgard uses 128-bit registers, which hold four
+ * 32-bit words, and later architectures use 32-bit registers.
+ */
+struct register_rules {
+    uint32_t min_architecture_major;
+    uint32_t num_full_occupancy_registers;
+    uint32_t max_work_registers;
+    uint32_t num_register_words;
+    uint32_t num_uniform_registers;
+};
+
+constexpr register_rules REGISTER_RULES[] {
+    //                 Arch, Full,  Max, Words, Uniforms
+    register_rules {      4,    4,   16,     4,       16 }, // Midgard
+    register_rules {      6,   32,   64,     1,       64 }, // Bifrost
+    register_rules {      9,   32,   64,     1,      128 }, // Valhall and later
+};
+
+/**
+ * Get the work register rules for an architecture.
+ *
+ * @param architecture_major   The architecture major version.
+ *
+ * @return The rules, or @c nullptr if the architecture is unknown.
+ */
+constexpr const register_rules* get_register_rules(
+    uint32_t architecture_major
+) {
+    const register_rules* result { nullptr };
+    for (const auto& rules : REGISTER_RULES)
+    {
+        if (architecture_major >= rules.min_architecture_major)
+        {
+            result = &rules;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Check that every catalog product has work register rules, and a thread
+ * count that halves exactly at every register allocation step.
+ *
+ * @return @c true if the catalog is valid.
+ */
+constexpr bool validate_register_rules()
+{
+    for (const auto& entry : PRODUCT_VERSIONS)
+    {
+        uint32_t major { 0 };
+        uint32_t minor { 0 };
+        get_architecture_version(entry.id, entry.id << 16, major, minor);
+
+        const register_rules* rules = get_register_rules(major);
+        if (!rules || !entry.num_threads_per_core)
+        {
+            return false;
+        }
+
+        const uint32_t steps = rules->max_work_registers / rules->num_full_occupancy_registers;
+        if (entry.num_threads_per_core % steps)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static_assert(validate_register_rules(), "Catalog products must have valid register rules");
+
+/** Number of catalog entries. */
+constexpr uint32_t num_product_versions { sizeof(PRODUCT_VERSIONS) / sizeof(PRODUCT_VERSIONS[0]) };
+
+/** Decoders whose value depends on the core configuration. */
+constexpr variant_decoder VARIANT_DECODERS[] {
+    get_num_eng_g31,
+    get_num_eng_g51,
+    get_num_eng_g52,
+    get_num_fma_g510,
+    get_num_tex_g510,
+    get_num_pix_g510,
+    get_num_eng_g510,
+    get_num_i8_g510,
+    get_num_f16_g510
+};
+
+constexpr bool is_variant_decoder(
+    variant_decoder decoder
+) {
+    for (const auto variant : VARIANT_DECODERS)
+    {
+        if (decoder == variant)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+constexpr bool is_variant_entry(
+    const product_entry& entry
+) {
+    return is_variant_decoder(entry.get_num_fp32_fmas_per_engine) ||
+           is_variant_decoder(entry.get_num_texels) ||
+           is_variant_decoder(entry.get_num_pixels) ||
+           is_variant_decoder(entry.get_num_exec_engines) ||
+           is_variant_decoder(entry.get_num_int8_macs_per_engine) ||
+           is_variant_decoder(entry.get_num_fp16_macs_per_engine);
+}
+
+/**
+ * The catalog in struct-of-arrays form, for batch lookups.
+ *
+ * Index num_product_versions is a sentinel for configurations that are not
+ * in the catalog, with "Unknown" names and zero rates. The per-core rates of
+ * variant entries are for a single core with zero feature registers, so
+ * batch lookups must use the decoders for entries marked as variant.
+ */
+struct catalog_columns {
+    const char* name[num_product_versions + 1];
+    const char* architecture[num_product_versions + 1];
+    uint32_t num_exec_engines[num_product_versions + 1];
+    uint32_t num_fp32_fmas[num_product_versions + 1];
+    uint32_t num_int8_macs[num_product_versions + 1];
+    uint32_t num_fp16_macs[num_product_versions + 1];
+    uint32_t num_texels[num_product_versions + 1];
+    uint32_t num_pixels[num_product_versions + 1];
+    uint32_t num_tiler_prims[num_product_versions + 1];
+    uint32_t num_threads[num_product_versions + 1];
+    bool is_variant[num_product_versions + 1];
+};
+
+constexpr catalog_columns make_catalog_columns()
+{
+    catalog_columns columns {};
+    for (uint32_t i = 0; i < num_product_versions; i++)
+    {
+        const auto& entry = PRODUCT_VERSIONS[i];
+        const uint32_t engines = entry.get_num_exec_engines(1, 0, 0);
+
+        columns.name[i] = entry.name;
+        columns.architecture[i] = entry.architecture;
+        columns.num_exec_engines[i] = engines;
+        columns.num_fp32_fmas[i] = entry.get_num_fp32_fmas_per_engine(1, 0, 0) * engines;
+        columns.num_int8_macs[i] = entry.get_num_int8_macs_per_engine(1, 0, 0) * engines;
+        columns.num_fp16_macs[i] = entry.get_num_fp16_macs_per_engine(1, 0, 0) * engines;
+        columns.num_texels[i] = entry.get_num_texels(1, 0, 0);
+        columns.num_pixels[i] = entry.get_num_pixels(1, 0, 0);
+        columns.num_tiler_prims[i] = entry.num_tiler_prims_per_cy;
+        columns.num_threads[i] = entry.num_threads_per_core;
+        columns.is_variant[i] = is_variant_entry(entry);
+    }
+
+    columns.name[num_product_versions] = "Unknown";
+    columns.architecture[num_product_versions] = "Unknown";
+    return columns;
+}
+
+constexpr catalog_columns CATALOG_COLUMNS = make_catalog_columns();
+
+/**
+ * Check that the decoders of every entry that is not marked as variant give
+ * the same value for a range of core configurations, so that a decoder that
+ * is missing from VARIANT_DECODERS is caught at build time.
+ *
+ * @return @c true if the catalog columns are valid.
+ */
+constexpr bool validate_catalog_columns()
+{
+    constexpr uint32_t core_counts[] { 1, 2, 3, 4, 5, 6, 7, 8, 10, 16, 32, 64 };
+    constexpr uint32_t features[] { 0, 0x1, 0xFF, 0xFF00, 0x10000, 0xFFFFFFFF };
+
+    for (const auto& entry : PRODUCT_VERSIONS)
+    {
+        if (is_variant_entry(entry))
+        {
+            continue;
+        }
+
+        const variant_decoder decoders[] {
+            entry.get_num_fp32_fmas_per_engine,
+            entry.get_num_texels,
+            entry.get_num_pixels,
+            entry.get_num_exec_engines,
+            entry.get_num_int8_macs_per_engine,
+            entry.get_num_fp16_macs_per_engine
+        };
+
+        for (const auto decoder : decoders)
+        {
+            const uint32_t value = decoder(1, 0, 0);
+            for (const uint32_t cores : core_counts)
+            {
+                for (const uint32_t core_features : features)
+                {
+                    for (const uint32_t thread_features : features)
+                    {
+                        if (decoder(cores, core_features, thread_features) != value)
+                        {
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+static_assert(validate_catalog_columns(), "Configuration-dependent decoders must be listed in VARIANT_DECODERS");
+
+// Catalog lookups must remain usable in constant expressions
+static_assert(get_num_fp32_fmas(0xa002, 1, 0, 0) == 64, "Catalog lookups must be constexpr");
+
+}
+}
@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief The libGPUInfo static device profile.
+ *
+ * Products with fixed hardware, such as automotive or set-top devices, can
+ * declare the GPU configuration at build time. The GPU information is then a
+ * constexpr value, available without opening the kernel driver:
+ *
+ *     constexpr gpuinfo info = libarmgpuinfo::get_static_info();
+ *
+ * The profile is declared using the LIBGPUINFO_STATIC_PROFILE_* macros, which
+ * are normally set by the LIBGPUINFO_STATIC_PROFILE CMake options. An optional
+ * one-shot check can verify the profile against the real device on a
+ * background thread, keeping the driver query off the boot-critical path:
+ *
+ *     std::future<bool> check = libarmgpuinfo::verify_static_profile();
+ *     ...
+ *     if (!check.get())
+ *     {
+ *         // Hardware does not match the build-time profile
+ *     }
+ *
+ * The check uses std::async, so code that calls it must link the threading
+ * library, e.g. Threads::Threads in CMake. The library itself does not.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <future>
+
+#include "libgpuinfo.hpp"
+#include "libgpuinfo_products.hpp"
+
+#if defined(LIBGPUINFO_STATIC_PROFILE)
+
+#if !defined(LIBGPUINFO_STATIC_PROFILE_PRODUCT_ID) || !defined(LIBGPUINFO_STATIC_PROFILE_CORE_MASK)
+    #error "Static profile requires LIBGPUINFO_STATIC_PROFILE_PRODUCT_ID and LIBGPUINFO_STATIC_PROFILE_CORE_MASK"
+#endif
+
+#if !defined(LIBGPUINFO_STATIC_PROFILE_CORE_FEATURES)
+    #define LIBGPUINFO_STATIC_PROFILE_CORE_FEATURES 0
+#endif
+
+#if !defined(LIBGPUINFO_STATIC_PROFILE_THREAD_FEATURES)
+    #define LIBGPUINFO_STATIC_PROFILE_THREAD_FEATURES 0
+#endif
+
+#if !defined(LIBGPUINFO_STATIC_PROFILE_L2_FEATURES)
+    #define LIBGPUINFO_STATIC_PROFILE_L2_FEATURES 0
+#endif
+
+#if !defined(LIBGPUINFO_STATIC_PROFILE_L2_SLICES)
+    #define LIBGPUINFO_STATIC_PROFILE_L2_SLICES 1
+#endif
+
+namespace libarmgpuinfo {
+
+/** Static device profile, declared at build time. */
+struct static_profile
+{
+    /** GPU product ID, e.g. 0xa002. */
+    uint32_t product_id;
+
+    /** Shader core topology mask. */
+    uint64_t core_mask;
+
+    /** Raw CORE_FEATURES register value. */
+    uint32_t core_features;
+
+    /** Raw THREAD_FEATURES register value. */
+    uint32_t thread_features;
+
+    /** Raw L2_FEATURES register value, or zero if unknown. */
+    uint32_t l2_features;
+
+    /** Number of L2 cache slices. */
+    uint32_t num_l2_slices;
+};
+
+/** The static device profile declared for this build. */
+constexpr static_profile STATIC_PROFILE {
+    LIBGPUINFO_STATIC_PROFILE_PRODUCT_ID,
+    LIBGPUINFO_STATIC_PROFILE_CORE_MASK,
+    LIBGPUINFO_STATIC_PROFILE_CORE_FEATURES,
+    LIBGPUINFO_STATIC_PROFILE_THREAD_FEATURES,
+    LIBGPUINFO_STATIC_PROFILE_L2_FEATURES,
+    LIBGPUINFO_STATIC_PROFILE_L2_SLICES
+};
+
+/**
+ * Get the GPU information for a static device profile.
+ *
+ * @param profile   The device profile.
+ *
+ * @return The GPU information.
+ */
+constexpr gpuinfo get_static_info(
+    const static_profile& profile
+) {
+    gpuinfo info {};
+
+    const uint32_t num_cores = __builtin_popcountll(profile.core_mask);
+
+    info.gpu_id = detail::get_gpu_id(profile.product_id);
+    info.gpu_name = detail::get_gpu_name(info.gpu_id, num_cores);
+    info.architecture_name = detail::get_architecture_name(info.gpu_id);
+
+    detail::get_architecture_version(
+        info.gpu_id,
+        profile.product_id << 16,
+        info.architecture_major,
+        info.architecture_minor);
+
+    info.num_shader_cores = num_cores;
+    info.shader_core_mask = profile.core_mask;
+    info.topology = make_core_topology(profile.core_mask);
+
+    // L2 features stores log2(line size) in bits [7:0], log2(slice size) in
+    // bits [23:16], and log2(bus width) in the top 8 bits
+    if (profile.l2_features)
+    {
+        info.num_l2_slices = profile.num_l2_slices;
+        info.num_l2_line_bytes = 1UL << (profile.l2_features & 0xFF);
+        info.num_l2_slice_bytes = 1UL << ((profile.l2_features >> 16) & 0xFF);
+        info.num_l2_bytes = info.num_l2_slice_bytes * profile.num_l2_slices;
+        info.num_bus_bits = 1UL << ((profile.l2_features >> 24) & 0xFF);
+    }
+
+    info.num_exec_engines = detail::get_num_exec_engines(
+        info.gpu_id,
+        num_cores,
+        profile.core_features,
+        profile.thread_features);
+
+    info.num_fp32_fmas_per_cy = detail::get_num_fp32_fmas(
+        info.gpu_id,
+        num_cores,
+        profile.core_features,
+        profile.thread_features);
+
+    info.num_fp16_fmas_per_cy = info.num_fp32_fmas_per_cy * 2;
+
+    info.num_int8_macs_per_cy = detail::get_num_int8_macs(
+        info.gpu_id,
+        num_cores,
+        profile.core_features,
+        profile.thread_features);
+
+    info.num_fp16_macs_per_cy = detail::get_num_fp16_macs(
+        info.gpu_id,
+        num_cores,
+        profile.core_features,
+        profile.thread_features);
+
+    info.num_texels_per_cy = detail::get_num_texels(
+        info.gpu_id,
+        num_cores,
+        profile.core_features,
+        profile.thread_features);
+
+    info.num_pixels_per_cy = detail::get_num_pixels(
+        info.gpu_id,
+        num_cores,
+        profile.core_features,
+        profile.thread_features);
+
+    info.tiler.num_prims_per_cy = detail::get_num_tiler_prims(info.gpu_id);
+    info.num_threads_per_core = detail::get_num_threads(info.gpu_id);
+
+    return info;
+}
+
+/**
+ * Get the GPU information for the static device profile of this build.
+ *
+ * @return The GPU information.
+ */
+constexpr gpuinfo get_static_info()
+{
+    return get_static_info(STATIC_PROFILE);
+}
+
+static_assert(get_static_info().num_exec_engines != 0,
+              "Static profile product ID is not in the product catalog");
+
+/**
+ * Test if device information matches the static device profile.
+ *
+ * Memory system information is only compared if the profile declares it.
+ *
+ * @param info   The device information queried from the kernel driver.
+ *
+ * @return @c true if the device matches the profile.
+ */
+inline bool matches_static_profile(
+    const gpuinfo& info
+) {
+    constexpr gpuinfo profile = get_static_info();
+
+    bool match = (info.gpu_id == profile.gpu_id) &&
+                 (info.shader_core_mask == profile.shader_core_mask) &&
+                 (info.num_exec_engines == profile.num_exec_engines) &&
+                 (info.num_fp32_fmas_per_cy == profile.num_fp32_fmas_per_cy) &&
+                 (info.num_texels_per_cy == profile.num_texels_per_cy) &&
+                 (info.num_pixels_per_cy == profile.num_pixels_per_cy);
+
+    if (profile.num_l2_slices)
+    {
+        match = match &&
+                (info.num_l2_slices == profile.num_l2_slices) &&
+                (info.num_l2_bytes == profile.num_l2_bytes) &&
+                (info.num_l2_line_bytes == profile.num_l2_line_bytes) &&
+                (info.num_bus_bits == profile.num_bus_bits);
+    }
+
+    return match;
+}
+
+/**
+ * Verify the static device profile against the real device.
+ *
+ * The check runs once, on a background thread.
+ *
+ * @param id   The driver instance, e.g. 0 for /dev/mali0.
+ *
+ * @return A future that becomes @c true if the device matches the profile,
+ *         or @c false if it does not match or could not be queried.
+ */
+inline std::future<bool> verify_static_profile(
+    const uint32_t id=0
+) {
+    return std::async(std::launch::async, [id]() {
+        std::unique_ptr<instance> conn = instance::create(id);
+        return conn && matches_static_profile(conn->get_info());
+    });
+}
+
+/**
+ * Verify the static device profile against a device using a custom driver.
+ *
+ * The check runs once, on a background thread.
+ *
+ * @param driver   The kernel driver system call interface, which must remain
+ *                 valid until the future is ready.
+ * @param id       The driver instance, e.g. 0 for /dev/mali0.
+ *
+ * @return A future that becomes @c true if the device matches the profile,
+ *         or @c false if it does not match or could not be queried.
+ */
+inline std::future<bool> verify_static_profile(
+    const driver_interface& driver,
+    const uint32_t id=0
+) {
+    return std::async(std::launch::async, [&driver, id]() {
+        std::unique_ptr<instance> conn = instance::create(id, driver);
+        return conn && matches_static_profile(conn->get_info());
+    });
+}
+
+}
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Report of the library results, for comparing library configurations.
+ *
+ * Usage:
+ *
+ *     libgpuinfo_modes
+ *     libgpuinfo_modes_header_only
+ *
+ * The same source is built against the compiled library and against the
+ * header-only configuration, and each build writes the same report to
+ * stdout. The report contains the product information of every catalog entry
+ * at each shader core count boundary, and the decoded capture and fake kernel
+ * driver query of every synthetic corpus case. The libgpuinfo_modes test runs
+ * both builds and checks that their reports are identical.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "libgpuinfo_products.hpp"
+#include "fake_driver/libgpuinfo_corpus.hpp"
+#include "fake_driver/libgpuinfo_fake_driver.hpp"
+
+using namespace libarmgpuinfo;
+
+namespace {
+
+/** Report the product information of a catalog entry with a core count. */
+void report_product(const detail::product_entry& entry, uint32_t num_cores)
+{
+    const gpuinfo info = get_product_info(entry.id, num_cores);
+
+    std::cout << "product 0x" << std::hex << entry.id << std::dec << " " << num_cores
+              << "c: " << fake::format_info(info) << "\n";
+}
+
+/** Report the decoded capture and the fake driver query of a corpus case. */
+void report_case(const fake::corpus_case& test)
+{
+    gpuinfo info {};
+    const auto capture = fake::encode_capture(test.gpu);
+    std::cout << "decode " << test.name << ": "
+              << (decode_capture(capture.data(), capture.size(), info) ? fake::format_info(info) : "decode failed")
+              << "\n";
+
+    fake::remove_devices();
+    fake::install_device(test.gpu);
+    std::unique_ptr<instance> inst = instance::create(0, fake::get_driver());
+    fake::remove_devices();
+
+    std::cout << "query " << test.name << ": "
+              << (inst ? fake::format_info(inst->get_info()) : "query failed") << "\n";
+}
+
+}
+
+int main()
+{
+    // Every catalog entry at its minimum core count, and just below it
+    for (const auto& entry : detail::PRODUCT_VERSIONS) {
+        report_product(entry, entry.min_cores);
+        if (entry.min_cores > 1) {
+            report_product(entry, entry.min_cores - 1);
+        }
+    }
+
+    for (const auto& test : fake::make_corpus()) {
+        report_case(test);
+    }
+
+    return std::cout ? EXIT_SUCCESS : EXIT_FAILURE;
+}
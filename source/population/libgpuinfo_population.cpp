@@ -0,0 +1,446 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Command line tool for synthetic device populations.
+ *
+ * Usage:
+ *
+ *     libgpuinfo_population [--records <n>] [--output <file>] [--seed <n>]
+ *                           [--configs <n>] [--product <id>=<weight> ...]
+ *                           [--max-cores <n>] [--kernels <pre_r21>:<jm>:<csf>]
+ *                           [--variants <fraction>] [--shuffle <fraction>]
+ *                           [--unknown <fraction>] [--max-unknown <n>]
+ *                           [--popularity <exponent>]
+ *     libgpuinfo_population --verify
+ *
+ * The population stream is written to the output file if specified, and is
+ * otherwise generated in memory and discarded, which measures the generation
+ * throughput. For example, a stream of ten million devices, mostly Mali-G710
+ * and Mali-G610, for ingestion by libgpuinfo_fleet ingest-stream:
+ *
+ *     libgpuinfo_population --records 10000000 --output fleet.bin
+ *                           --product 0xa002=3 --product 0xa007=2 --product 0x9002=1
+ *
+ * The verify mode checks that the generated stream follows the configured
+ * distributions, that it does not depend on the generation buffer size, and
+ * that every property buffer layout decodes to the same result as the kbase
+ * layout of the same configuration.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "libgpuinfo.hpp"
+#include "fake_driver/libgpuinfo_corpus.hpp"
+#include "fake_driver/libgpuinfo_fake_driver.hpp"
+#include "fake_driver/libgpuinfo_population.hpp"
+
+using namespace libarmgpuinfo;
+
+namespace {
+
+/** Size of the generation buffer. */
+constexpr std::size_t buffer_size { 64 * 1024 * 1024 };
+
+/** The default number of records to generate. */
+constexpr uint64_t default_records { 1000000 };
+
+/** The number of records generated by the verify mode, limited by the buffer size. */
+constexpr uint64_t verify_records { 1000000 };
+
+/** The number of records sampled by the verify mode to check their frequencies. */
+constexpr uint64_t verify_samples { 4000000 };
+
+/** The allowed difference between a configured and a sampled fraction. */
+constexpr double fraction_tolerance { 0.03 };
+
+/** The allowed relative difference between a configured and a sampled record frequency. */
+constexpr double frequency_tolerance { 0.05 };
+
+/** The number of most popular configurations whose record frequencies are checked. */
+constexpr uint32_t num_checked_frequencies { 16 };
+
+/** Generate a stream, writing it to a file if one is given. */
+int generate(fake::population_generator& generator, uint64_t num_records, const std::string& output_path)
+{
+    std::unique_ptr<FILE, int (*)(FILE*)> out { nullptr, std::fclose };
+    if (!output_path.empty()) {
+        out.reset(std::fopen(output_path.c_str(), "wb"));
+        if (!out) {
+            std::cerr << "ERROR: Failed to create " << output_path << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<unsigned char> buffer(buffer_size);
+    uint64_t total_records { 0 };
+    uint64_t total_bytes { 0 };
+
+    const auto start = std::chrono::steady_clock::now();
+    while (total_records < num_records) {
+        uint64_t count { 0 };
+        const std::size_t size = generator.generate(buffer.data(), buffer.size(), num_records - total_records, count);
+        if (out && (std::fwrite(buffer.data(), 1, size, out.get()) != size)) {
+            std::cerr << "ERROR: Failed to write " << output_path << "\n";
+            return EXIT_FAILURE;
+        }
+
+        total_records += count;
+        total_bytes += size;
+    }
+
+    if (out && (std::fclose(out.release()) != 0)) {
+        std::cerr << "ERROR: Failed to write " << output_path << "\n";
+        return EXIT_FAILURE;
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const double seconds = std::max(elapsed.count(), 1e-9);
+    std::cout << "Generated " << total_records << " devices, " << total_bytes << " bytes, from "
+              << generator.get_configs().size() << " configurations\n";
+    std::cout << "Throughput: " << (total_bytes / seconds) / 1e9 << " GB/s, "
+              << (total_records / seconds) / 1e6 << " M devices/s\n";
+    return EXIT_SUCCESS;
+}
+
+/** Check that a sampled fraction is close to the configured fraction. */
+bool check_fraction(const char* name, uint64_t count, uint64_t total, double expected)
+{
+    const double actual = total ? static_cast<double>(count) / static_cast<double>(total) : 0.0;
+    if (std::fabs(actual - expected) > fraction_tolerance) {
+        std::cerr << "FAIL: " << name << " fraction is " << actual << ", expected " << expected << "\n";
+        return false;
+    }
+
+    return true;
+}
+
+/** Check that the configuration pool follows the configured distributions. */
+bool verify_pool(const fake::population_config& config, const fake::population_generator& generator)
+{
+    const auto& configs = generator.get_configs();
+    if (configs.size() != config.num_configs) {
+        std::cerr << "FAIL: Pool has " << configs.size() << " configurations, expected "
+                  << config.num_configs << "\n";
+        return false;
+    }
+
+    uint64_t kernel_counts[fake::num_kernel_types] {};
+    uint64_t num_post_r21 { 0 };
+    uint64_t num_shuffled { 0 };
+    uint64_t num_unknown { 0 };
+    bool pass { true };
+    for (uint32_t i = 0; i < configs.size(); i++) {
+        const auto& gpu = configs[i];
+        kernel_counts[static_cast<uint32_t>(gpu.kernel)]++;
+        if (gpu.kernel != fake::kernel_type::post_r21_jm && gpu.kernel != fake::kernel_type::post_r21_csf) {
+            continue;
+        }
+
+        num_post_r21++;
+        num_shuffled += gpu.prop_order_seed ? 1 : 0;
+        num_unknown += gpu.num_unknown_props ? 1 : 0;
+
+        // Every property buffer layout must decode like the kbase layout
+        if (!gpu.prop_order_seed && !gpu.num_unknown_props) {
+            continue;
+        }
+
+        auto canonical = gpu;
+        canonical.prop_order_seed = 0;
+        canonical.num_unknown_props = 0;
+        const auto canonical_capture = fake::encode_capture(canonical);
+
+        std::size_t size { 0 };
+        const unsigned char* capture = generator.get_capture(i, size);
+        gpuinfo info {};
+        gpuinfo canonical_info {};
+        if (!decode_capture(capture, size, info) ||
+            !decode_capture(canonical_capture.data(), canonical_capture.size(), canonical_info) ||
+            (fake::format_info(info) != fake::format_info(canonical_info))) {
+            std::cerr << "FAIL: Configuration " << i << " layout decodes differently from kbase layout\n";
+            pass = false;
+        }
+    }
+
+    double total_weight { 0.0 };
+    for (double weight : config.kernel_weights) {
+        total_weight += weight;
+    }
+
+    const char* kernel_names[fake::num_kernel_types] { "pre-r21", "post-r21 JM", "post-r21 CSF" };
+    for (uint32_t k = 0; k < fake::num_kernel_types; k++) {
+        pass &= check_fraction(kernel_names[k], kernel_counts[k], configs.size(),
+                               config.kernel_weights[k] / total_weight);
+    }
+
+    pass &= check_fraction("Shuffled layout", num_shuffled, num_post_r21, config.shuffle_fraction);
+    pass &= check_fraction("Unknown property", num_unknown, num_post_r21, config.unknown_fraction);
+    return pass;
+}
+
+/** Check that the record stream follows the configuration popularity. */
+bool verify_stream(const fake::population_config& config)
+{
+    // Generate the same stream into a large buffer and a minimal buffer
+    fake::population_generator generator(config);
+    fake::population_generator reference(config);
+
+    std::vector<unsigned char> stream(buffer_size);
+    uint64_t num_records { 0 };
+    const std::size_t stream_size = generator.generate(stream.data(), stream.size(), verify_records, num_records);
+
+    std::size_t max_capture_size { 0 };
+    for (uint32_t i = 0; i < generator.get_configs().size(); i++) {
+        std::size_t size { 0 };
+        generator.get_capture(i, size);
+        max_capture_size = std::max(max_capture_size, size);
+    }
+
+    std::vector<unsigned char> small(max_capture_size);
+    std::vector<unsigned char> copy;
+    uint64_t num_copied { 0 };
+    while (copy.size() < stream_size) {
+        uint64_t count { 0 };
+        const std::size_t size = reference.generate(small.data(), small.size(), UINT64_MAX, count);
+        copy.insert(copy.end(), small.begin(), small.begin() + size);
+        num_copied += count;
+    }
+
+    if ((copy.size() != stream_size) || (num_copied != num_records) ||
+        (std::memcmp(copy.data(), stream.data(), stream_size) != 0)) {
+        std::cerr << "FAIL: Stream depends on the generation buffer size\n";
+        return false;
+    }
+
+    // Every record must be a whole pool capture
+    std::vector<bool> decoded(generator.get_configs().size());
+    std::set<std::vector<unsigned char>> distinct;
+    fake::population_generator indices(config);
+    const unsigned char* data = stream.data();
+    std::size_t remaining = stream_size;
+    const unsigned char* capture { nullptr };
+    std::size_t capture_size { 0 };
+    uint64_t num_split { 0 };
+    while (fake::next_stream_capture(data, remaining, capture, capture_size)) {
+        const uint32_t index = indices.next_config();
+        std::size_t expected_size { 0 };
+        const unsigned char* expected = generator.get_capture(index, expected_size);
+        if ((capture_size != expected_size) || (std::memcmp(capture, expected, capture_size) != 0)) {
+            std::cerr << "FAIL: Record " << num_split << " is not configuration " << index << "\n";
+            return false;
+        }
+
+        if (!decoded[index]) {
+            gpuinfo info {};
+            if (!decode_capture(capture, capture_size, info)) {
+                std::cerr << "FAIL: Configuration " << index << " does not decode\n";
+                return false;
+            }
+
+            decoded[index] = true;
+            distinct.emplace(capture, capture + capture_size);
+        }
+
+        num_split++;
+    }
+
+    if (remaining || (num_split != num_records)) {
+        std::cerr << "FAIL: Split " << num_split << " records, expected " << num_records << "\n";
+        return false;
+    }
+
+    // Sample more records than fit in the buffer to check the popularity
+    std::vector<uint64_t> counts(generator.get_configs().size());
+    fake::population_generator sampler(config);
+    for (uint64_t i = 0; i < verify_samples; i++) {
+        counts[sampler.next_config()]++;
+    }
+
+    bool pass { true };
+    const auto& frequencies = generator.get_frequencies();
+    for (uint32_t i = 0; (i < num_checked_frequencies) && (i < counts.size()); i++) {
+        const double actual = static_cast<double>(counts[i]) / static_cast<double>(verify_samples);
+        if (std::fabs(actual - frequencies[i]) > (frequencies[i] * frequency_tolerance)) {
+            std::cerr << "FAIL: Configuration " << i << " frequency is " << actual
+                      << ", expected " << frequencies[i] << "\n";
+            pass = false;
+        }
+    }
+
+    std::cout << "Stream: " << num_records << " records, " << stream_size << " bytes, "
+              << distinct.size() << " distinct captures\n";
+    return pass;
+}
+
+/** Verify the generator. */
+int verify()
+{
+    bool pass { true };
+
+    fake::population_config config;
+    fake::population_generator generator(config);
+    pass &= verify_pool(config, generator);
+    pass &= verify_stream(config);
+
+    // Skewed distributions, including layouts that every configuration uses
+    fake::population_config skewed;
+    skewed.seed = 7;
+    skewed.num_configs = 1024;
+    skewed.product_weights = { { 0xa002, 3.0 }, { 0x7002, 1.0 } };
+    skewed.kernel_weights[0] = 0.0;
+    skewed.shuffle_fraction = 1.0;
+    skewed.unknown_fraction = 1.0;
+    skewed.popularity_exponent = 0.0;
+    fake::population_generator skewed_generator(skewed);
+    pass &= verify_pool(skewed, skewed_generator);
+    pass &= verify_stream(skewed);
+
+    // Products outside the configured weights must not be generated
+    for (const auto& gpu : skewed_generator.get_configs()) {
+        const uint32_t product_id = static_cast<uint32_t>(gpu.raw_gpu_id >> 16);
+        if ((product_id != 0xa002) && (product_id != 0x7002)) {
+            std::cerr << "FAIL: Unexpected product 0x" << std::hex << product_id << std::dec << "\n";
+            pass = false;
+            break;
+        }
+    }
+
+    // A generator with no products has no configurations and generates nothing
+    fake::population_config empty;
+    empty.product_weights = { { 0xa002, 0.0 } };
+    fake::population_generator empty_generator(empty);
+    unsigned char byte { 0 };
+    uint64_t count { 0 };
+    if (!empty_generator.get_configs().empty() || empty_generator.generate(&byte, 1, 1, count) || count) {
+        std::cerr << "FAIL: Empty population generated records\n";
+        pass = false;
+    }
+
+    std::cout << (pass ? "PASS" : "FAIL") << "\n";
+    return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/** Parse a <id>=<weight> product weight. */
+bool parse_product(const std::string& text, std::pair<uint32_t, double>& product)
+{
+    const auto split = text.find('=');
+    if (split == std::string::npos) {
+        return false;
+    }
+
+    product.first = static_cast<uint32_t>(std::strtoul(text.substr(0, split).c_str(), nullptr, 0));
+    product.second = std::strtod(text.substr(split + 1).c_str(), nullptr);
+    return true;
+}
+
+/** Parse <pre_r21>:<jm>:<csf> kernel weights. */
+bool parse_kernels(const std::string& text, double (&weights)[fake::num_kernel_types])
+{
+    const char* cursor = text.c_str();
+    for (uint32_t k = 0; k < fake::num_kernel_types; k++) {
+        char* end { nullptr };
+        weights[k] = std::strtod(cursor, &end);
+        if ((end == cursor) || (*end != ((k + 1 < fake::num_kernel_types) ? ':' : '\0'))) {
+            return false;
+        }
+
+        cursor = end + 1;
+    }
+
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    fake::population_config config;
+    uint64_t num_records { default_records };
+    std::string output_path;
+    bool valid { true };
+
+    for (int i = 1; valid && (i < argc); i++) {
+        std::string arg { argv[i] };
+        const bool has_value = (i + 1 < argc);
+        if ((arg == "--verify") && (argc == 2)) {
+            return verify();
+        } else if ((arg == "--records") && has_value) {
+            num_records = std::strtoull(argv[++i], nullptr, 0);
+        } else if ((arg == "--output") && has_value) {
+            output_path = argv[++i];
+        } else if ((arg == "--seed") && has_value) {
+            config.seed = std::strtoull(argv[++i], nullptr, 0);
+        } else if ((arg == "--configs") && has_value) {
+            config.num_configs = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if ((arg == "--product") && has_value) {
+            std::pair<uint32_t, double> product;
+            valid = parse_product(argv[++i], product);
+            config.product_weights.push_back(product);
+        } else if ((arg == "--max-cores") && has_value) {
+            config.max_cores = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if ((arg == "--kernels") && has_value) {
+            valid = parse_kernels(argv[++i], config.kernel_weights);
+        } else if ((arg == "--variants") && has_value) {
+            config.variant_fraction = std::strtod(argv[++i], nullptr);
+        } else if ((arg == "--shuffle") && has_value) {
+            config.shuffle_fraction = std::strtod(argv[++i], nullptr);
+        } else if ((arg == "--unknown") && has_value) {
+            config.unknown_fraction = std::strtod(argv[++i], nullptr);
+        } else if ((arg == "--max-unknown") && has_value) {
+            config.max_unknown_props = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if ((arg == "--popularity") && has_value) {
+            config.popularity_exponent = std::strtod(argv[++i], nullptr);
+        } else {
+            valid = false;
+        }
+    }
+
+    if (!valid) {
+        std::cerr << "Usage: libgpuinfo_population [--records <n>] [--output <file>] [--seed <n>]\n"
+                  << "           [--configs <n>] [--product <id>=<weight> ...] [--max-cores <n>]\n"
+                  << "           [--kernels <pre_r21>:<jm>:<csf>] [--variants <fraction>]\n"
+                  << "           [--shuffle <fraction>] [--unknown <fraction>] [--max-unknown <n>]\n"
+                  << "           [--popularity <exponent>]\n"
+                  << "       libgpuinfo_population --verify\n";
+        return EXIT_FAILURE;
+    }
+
+    fake::population_generator generator(config);
+    if (generator.get_configs().empty()) {
+        std::cerr << "ERROR: No configurations match the product and kernel weights\n";
+        return EXIT_FAILURE;
+    }
+
+    return generate(generator, num_records, output_path);
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2024 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @brief Checks of the static device profile.
+ *
+ * Usage:
+ *
+ *     libgpuinfo_profile
+ *
+ * Uses the static profile of the build, or declares a Mali-G710 profile if
+ * the build does not have one. The constexpr profile information is checked
+ * against the product catalog at compile time, and the profile verification
+ * is checked against matching and mismatching devices of the fake kernel
+ * driver. Failed checks are reported to stderr, and the exit code is non-zero
+ * if any check failed.
+ *
+ * The product lookup is only constexpr in the header-only configuration, so
+ * this check is built against it.
+ */
+
+// Declare a profile if the build does not, so that the check always runs
+#if !defined(LIBGPUINFO_STATIC_PROFILE)
+    #define LIBGPUINFO_STATIC_PROFILE
+    #define LIBGPUINFO_STATIC_PROFILE_PRODUCT_ID 0xa002
+    #define LIBGPUINFO_STATIC_PROFILE_CORE_MASK 0x3ff
+    #define LIBGPUINFO_STATIC_PROFILE_L2_FEATURES 0x07110206
+    #define LIBGPUINFO_STATIC_PROFILE_L2_SLICES 2
+#endif
+
+#include <cstdlib>
+#include <iostream>
+
+#include "libgpuinfo_profile.hpp"
+#include "fake_driver/libgpuinfo_fake_driver.hpp"
+
+using namespace libarmgpuinfo;
+
+namespace {
+
+/** Test if two strings are equal, at compile time. */
+constexpr bool is_same_string(const char* a, const char* b)
+{
+    return (!a || !b) ? (a == b) :
+           (*a != *b) ? false :
+           !*a ? true : is_same_string(a + 1, b + 1);
+}
+
+/** The profile information, and the catalog information for the same configuration. */
+constexpr gpuinfo static_info = get_static_info();
+constexpr gpuinfo product_info = get_product_info(
+    STATIC_PROFILE.product_id,
+    __builtin_popcountll(STATIC_PROFILE.core_mask),
+    STATIC_PROFILE.core_features,
+    STATIC_PROFILE.thread_features);
+
+static_assert(static_info.gpu_id == product_info.gpu_id,
+              "Profile GPU ID must match the catalog");
+static_assert(is_same_string(static_info.gpu_name, product_info.gpu_name),
+              "Profile GPU name must match the catalog");
+static_assert(is_same_string(static_info.architecture_name, product_info.architecture_name),
+              "Profile architecture name must match the catalog");
+static_assert((static_info.architecture_major == product_info.architecture_major) &&
+              (static_info.architecture_minor == product_info.architecture_minor),
+              "Profile architecture version must match the catalog");
+static_assert(static_info.num_shader_cores == product_info.num_shader_cores,
+              "Profile core count must match the catalog");
+static_assert(static_info.num_exec_engines == product_info.num_exec_engines,
+              "Profile execution engines must match the catalog");
+static_assert((static_info.num_fp32_fmas_per_cy == product_info.num_fp32_fmas_per_cy) &&
+              (static_info.num_fp16_fmas_per_cy == product_info.num_fp16_fmas_per_cy),
+              "Profile FMA rates must match the catalog");
+static_assert((static_info.num_int8_macs_per_cy == product_info.num_int8_macs_per_cy) &&
+              (static_info.num_fp16_macs_per_cy == product_info.num_fp16_macs_per_cy),
+              "Profile MAC rates must match the catalog");
+static_assert((static_info.num_texels_per_cy == product_info.num_texels_per_cy) &&
+              (static_info.num_pixels_per_cy == product_info.num_pixels_per_cy),
+              "Profile texel and pixel rates must match the catalog");
+static_assert(static_info.tiler.num_prims_per_cy == product_info.tiler.num_prims_per_cy,
+              "Profile tiler rate must match the catalog");
+static_assert(static_info.num_threads_per_core == product_info.num_threads_per_core,
+              "Profile thread count must match the catalog");
+
+/** Make a fake device with the profile configuration. */
+fake::fake_gpu make_profile_gpu()
+{
+    // Use the first kernel driver interface that the build supports
+    fake::kernel_type kernel { fake::kernel_type::post_r21_jm };
+    for (auto type : { fake::kernel_type::post_r21_jm, fake::kernel_type::post_r21_csf, fake::kernel_type::pre_r21 }) {
+        if (fake::is_kernel_enabled(type)) {
+            kernel = type;
+            break;
+        }
+    }
+
+    fake::fake_gpu gpu = fake::make_gpu(
+        kernel,
+        STATIC_PROFILE.product_id,
+        static_info.num_shader_cores,
+        STATIC_PROFILE.core_features,
+        STATIC_PROFILE.thread_features);
+
+    gpu.shader_present = STATIC_PROFILE.core_mask;
+    if (STATIC_PROFILE.l2_features) {
+        gpu.l2_features = STATIC_PROFILE.l2_features;
+        gpu.num_l2_slices = STATIC_PROFILE.num_l2_slices;
+    }
+
+    return gpu;
+}
+
+/** Verify the profile against a fake device. */
+bool verify_fake_device(const fake::fake_gpu& gpu)
+{
+    fake::remove_devices();
+    fake::install_device(gpu);
+    const bool match = verify_static_profile(fake::get_driver(), 0).get();
+    fake::remove_devices();
+    return match;
+}
+
+}
+
+int main()
+{
+    bool pass { true };
+
+    const fake::fake_gpu gpu = make_profile_gpu();
+    if (!verify_fake_device(gpu)) {
+        std::cerr << "FAIL: Profile does not match a device with the profile configuration\n";
+        pass = false;
+    }
+
+    // Remove the highest shader core
+    fake::fake_gpu missing_core = gpu;
+    missing_core.shader_present &= ~(1ULL << (63 - __builtin_clzll(gpu.shader_present)));
+    if (verify_fake_device(missing_core)) {
+        std::cerr << "FAIL: Profile matches a device with a missing shader core\n";
+        pass = false;
+    }
+
+    // Add an L2 cache slice, which is only compared if the profile declares it
+    fake::fake_gpu extra_slice = gpu;
+    extra_slice.num_l2_slices++;
+    if ((STATIC_PROFILE.l2_features != 0) && verify_fake_device(extra_slice)) {
+        std::cerr << "FAIL: Profile matches a device with an extra L2 cache slice\n";
+        pass = false;
+    }
+
+    if (!pass) {
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "PASS: Static profile of " << static_info.gpu_name << " MP"
+              << static_info.num_shader_cores << " verified\n";
+    return EXIT_SUCCESS;
+}